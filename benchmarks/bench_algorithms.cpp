@@ -0,0 +1,172 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// Generic iterator algorithms against the segment-aware cb:: versions over a
+// buffer that wraps in the middle.
+namespace {
+
+constexpr size_t kSize = 1 << 16;
+
+CircularBuffer<int> MakeWrapped() {
+    CircularBuffer<int> buff;
+    buff.reserve(kSize);
+
+    for (size_t i = 0; i < kSize + kSize / 2; ++i) {
+        buff.push_back(static_cast<int>(i % 1000));
+    }
+
+    return buff;
+}
+
+} // namespace
+
+static void BM_StdAccumulate(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(buff.begin(), buff.end(), 0LL));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_CbAccumulate(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::accumulate(buff, 0LL));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_StdFind(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(buff.begin(), buff.end(), -1));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_CbFind(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::find(buff, -1));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_StdCopy(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+    std::vector<int> out(kSize);
+
+    for (auto _ : state) {
+        std::copy(buff.begin(), buff.end(), out.begin());
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * kSize * sizeof(int));
+}
+
+static void BM_CbCopy(benchmark::State& state) {
+    const CircularBuffer<int> buff = MakeWrapped();
+    std::vector<int> out(kSize);
+
+    for (auto _ : state) {
+        cb::copy(buff, out.begin());
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * kSize * sizeof(int));
+}
+
+static void BM_StdFill(benchmark::State& state) {
+    CircularBuffer<int> buff = MakeWrapped();
+    int value = 0;
+
+    for (auto _ : state) {
+        std::fill(buff.begin(), buff.end(), ++value);
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kSize * sizeof(int));
+}
+
+static void BM_CbFill(benchmark::State& state) {
+    CircularBuffer<int> buff = MakeWrapped();
+    int value = 0;
+
+    for (auto _ : state) {
+        cb::fill(buff, ++value);
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kSize * sizeof(int));
+}
+
+static void BM_StdForEach(benchmark::State& state) {
+    CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        std::for_each(buff.begin(), buff.end(), [](int& x) { x += 1; });
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_CbForEach(benchmark::State& state) {
+    CircularBuffer<int> buff = MakeWrapped();
+
+    for (auto _ : state) {
+        cb::for_each(buff, [](int& x) { x += 1; });
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+// The iterator path operator== took before it was routed through cb::equal.
+static void BM_StdEqual(benchmark::State& state) {
+    const CircularBuffer<int> lhs = MakeWrapped();
+    CircularBuffer<int> rhs(lhs.begin(), lhs.end());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+static void BM_CbEqual(benchmark::State& state) {
+    const CircularBuffer<int> lhs = MakeWrapped();
+    CircularBuffer<int> rhs(lhs.begin(), lhs.end());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+BENCHMARK(BM_StdAccumulate);
+BENCHMARK(BM_CbAccumulate);
+BENCHMARK(BM_StdFind);
+BENCHMARK(BM_CbFind);
+BENCHMARK(BM_StdCopy);
+BENCHMARK(BM_CbCopy);
+BENCHMARK(BM_StdFill);
+BENCHMARK(BM_CbFill);
+BENCHMARK(BM_StdForEach);
+BENCHMARK(BM_CbForEach);
+BENCHMARK(BM_StdEqual);
+BENCHMARK(BM_CbEqual);
@@ -0,0 +1,56 @@
+#include "../include/arena_allocator.h"
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+// A connection-per-buffer workload: every iteration opens a short-lived
+// buffer, streams a few messages through it and closes it again.
+namespace {
+
+constexpr int kMessages = 256;
+
+template<typename Buffer, typename... AllocArgs>
+void ServeConnection(AllocArgs&&... alloc) {
+    Buffer buff(std::forward<AllocArgs>(alloc)...);
+    buff.reserve(64);
+
+    for (int i = 0; i < kMessages; ++i) {
+        buff.push_back(i);
+    }
+
+    benchmark::DoNotOptimize(buff.front());
+}
+
+} // namespace
+
+static void BM_ConnectionStdAllocator(benchmark::State& state) {
+    for (auto _ : state) {
+        ServeConnection<CircularBuffer<int>>();
+    }
+}
+BENCHMARK(BM_ConnectionStdAllocator);
+
+static void BM_ConnectionArenaAllocator(benchmark::State& state) {
+    FixedArena arena(1 << 16);
+
+    for (auto _ : state) {
+        ServeConnection<CircularBuffer<int, ArenaAllocator<int>>>(arena);
+    }
+}
+BENCHMARK(BM_ConnectionArenaAllocator);
+
+static void BM_ConnectionPmrArena(benchmark::State& state) {
+    FixedArena arena(1 << 16);
+
+    for (auto _ : state) {
+        ServeConnection<cb::pmr::CircularBuffer<int>>(&arena);
+    }
+}
+BENCHMARK(BM_ConnectionPmrArena);
+
+static void BM_ConnectionFixedStorage(benchmark::State& state) {
+    for (auto _ : state) {
+        ServeConnection<StaticCircularBuffer<int, 64>>();
+    }
+}
+BENCHMARK(BM_ConnectionFixedStorage);
@@ -0,0 +1,133 @@
+#include "../include/blocking_circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kTransferred = 1 << 16;
+
+// The textbook queue: notify on every push and every pop.
+class NotifyEveryPushQueue {
+public:
+    explicit NotifyEveryPushQueue(std::size_t capacity) {
+        buffer_.reserve(capacity);
+    }
+
+    void push(int value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return buffer_.size() < buffer_.capacity(); });
+        buffer_.push_back(value);
+        ++wakeups_;
+        not_empty_.notify_one();
+    }
+
+    void pop(int& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !buffer_.empty(); });
+        value = buffer_.front();
+        buffer_.pop_front();
+        ++wakeups_;
+        not_full_.notify_one();
+    }
+
+    std::size_t wakeups() const {
+        return wakeups_;
+    }
+private:
+    CircularBuffer<int> buffer_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::size_t wakeups_ = 0;
+};
+
+} // namespace
+
+// state.range(0) producers stream kTransferred ints in total to the
+// benchmark thread. "wakeups" counts notify calls per transferred element.
+static void BM_NotifyEveryPush(benchmark::State& state) {
+    int producers = static_cast<int>(state.range(0));
+    double wakeups = 0;
+
+    for (auto _ : state) {
+        NotifyEveryPushQueue queue(1024);
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, producers]() {
+                for (int i = 0; i < kTransferred / producers; ++i) {
+                    queue.push(i);
+                }
+            });
+        }
+
+        int value;
+
+        for (int i = 0; i < kTransferred / producers * producers; ++i) {
+            queue.pop(value);
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        wakeups += static_cast<double>(queue.wakeups());
+    }
+
+    state.counters["wakeups"] = benchmark::Counter(wakeups / kTransferred, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * kTransferred);
+}
+BENCHMARK(BM_NotifyEveryPush)->Arg(1)->Arg(4)->UseRealTime();
+
+// state.range(1) is the wake threshold, state.range(2) the batch popped per
+// lock acquisition (1 means plain pop).
+static void BM_BlockingBuffer(benchmark::State& state) {
+    int producers = static_cast<int>(state.range(0));
+    std::size_t threshold = static_cast<std::size_t>(state.range(1));
+    std::size_t batch = static_cast<std::size_t>(state.range(2));
+    double wakeups = 0;
+
+    for (auto _ : state) {
+        BlockingCircularBuffer<int> buff(1024, threshold);
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&buff, producers]() {
+                for (int i = 0; i < kTransferred / producers; ++i) {
+                    buff.push(i);
+                }
+
+                // The tail may stay below the threshold.
+                buff.flush();
+            });
+        }
+
+        std::vector<int> out(batch);
+        int remaining = kTransferred / producers * producers;
+
+        while (remaining > 0) {
+            remaining -= static_cast<int>(buff.pop_batch(out.data(), batch));
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        wakeups += static_cast<double>(buff.wakeups());
+    }
+
+    state.counters["wakeups"] = benchmark::Counter(wakeups / kTransferred, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * kTransferred);
+}
+BENCHMARK(BM_BlockingBuffer)
+    ->Args({1, 1, 1})
+    ->Args({1, 64, 1})
+    ->Args({1, 64, 64})
+    ->Args({4, 1, 1})
+    ->Args({4, 64, 64})
+    ->UseRealTime();
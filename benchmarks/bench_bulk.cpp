@@ -0,0 +1,179 @@
+#include "../include/circular_buffer.h"
+
+#ifdef __linux__
+#include "../include/mirrored_circular_buffer.h"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Record {
+    char bytes[64];
+};
+
+constexpr size_t kCapacity = 1 << 16;
+constexpr size_t kBatch = 256;
+
+} // namespace
+
+static void BM_RecordPushBackLoop(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    std::vector<Record> batch(kBatch);
+
+    for (auto _ : state) {
+        for (const auto& record : batch) {
+            buff.push_back(record);
+        }
+
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+static void BM_RecordPushBackN(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    std::vector<Record> batch(kBatch);
+
+    for (auto _ : state) {
+        buff.push_back_n(batch.data(), batch.size());
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+static void BM_RecordPopFrontLoop(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    std::vector<Record> batch(kBatch);
+
+    for (auto _ : state) {
+        buff.push_back_n(batch.data(), batch.size());
+
+        for (auto& record : batch) {
+            record = buff.front();
+            buff.pop_front();
+        }
+
+        benchmark::DoNotOptimize(batch);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+static void BM_RecordPopFrontN(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    std::vector<Record> batch(kBatch);
+
+    for (auto _ : state) {
+        buff.push_back_n(batch.data(), batch.size());
+        buff.pop_front_n(batch.data(), batch.size());
+        benchmark::DoNotOptimize(batch);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+// A producer decoding frames into a staging batch that push_back_n copies,
+// against decoding straight into the ring through prepare/commit. The
+// consumer side reads one byte per record in both cases.
+static void DecodeRecord(Record& record, size_t i) {
+    std::memset(record.bytes, static_cast<int>(i), sizeof(record.bytes));
+}
+
+static void BM_RecordDecodeStaged(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    std::vector<Record> batch(kBatch);
+    size_t checksum = 0;
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < kBatch; ++i) {
+            DecodeRecord(batch[i], i);
+        }
+
+        buff.push_back_n(batch.data(), batch.size());
+        buff.pop_front_n(batch.data(), batch.size());
+
+        for (const auto& record : batch) {
+            checksum += record.bytes[0];
+        }
+    }
+
+    benchmark::DoNotOptimize(checksum);
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+static void BM_RecordDecodeInPlace(benchmark::State& state) {
+    CircularBuffer<Record> buff;
+    buff.reserve(kCapacity);
+
+    size_t checksum = 0;
+
+    for (auto _ : state) {
+        auto slots = buff.prepare(kBatch);
+        size_t i = 0;
+
+        for (Record& record : slots.first) {
+            DecodeRecord(record, i++);
+        }
+
+        for (Record& record : slots.second) {
+            DecodeRecord(record, i++);
+        }
+
+        buff.commit(slots.size());
+
+        auto view = buff.peek(kBatch);
+
+        for (const Record& record : view.first) {
+            checksum += record.bytes[0];
+        }
+
+        for (const Record& record : view.second) {
+            checksum += record.bytes[0];
+        }
+
+        buff.consume(view.size());
+    }
+
+    benchmark::DoNotOptimize(checksum);
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+#ifdef __linux__
+static void BM_RecordMirroredPushPopN(benchmark::State& state) {
+    MirroredCircularBuffer<Record> buff(kCapacity);
+    std::vector<Record> batch(kBatch);
+
+    for (auto _ : state) {
+        buff.push_back_n(batch.data(), batch.size());
+        buff.pop_front_n(batch.data(), batch.size());
+        benchmark::DoNotOptimize(batch);
+    }
+
+    state.SetBytesProcessed(state.iterations() * kBatch * sizeof(Record));
+}
+
+BENCHMARK(BM_RecordMirroredPushPopN);
+#endif
+
+BENCHMARK(BM_RecordPushBackLoop);
+BENCHMARK(BM_RecordPushBackN);
+BENCHMARK(BM_RecordPopFrontLoop);
+BENCHMARK(BM_RecordPopFrontN);
+BENCHMARK(BM_RecordDecodeStaged);
+BENCHMARK(BM_RecordDecodeInPlace);
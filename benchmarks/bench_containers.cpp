@@ -0,0 +1,285 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#if __has_include(<boost/circular_buffer.hpp>)
+#include <boost/circular_buffer.hpp>
+#define CBUFFER_BENCH_HAVE_BOOST 1
+#endif
+
+namespace {
+
+constexpr size_t kSize = 1 << 12;
+
+struct Record {
+    int64_t key;
+    char payload[56];
+
+    bool operator<(const Record& other) const {
+        return key < other.key;
+    }
+};
+
+template<typename T>
+T MakeValue(size_t i);
+
+template<>
+int MakeValue<int>(size_t i) {
+    return static_cast<int>(i * 2654435761u);
+}
+
+template<>
+Record MakeValue<Record>(size_t i) {
+    Record record{};
+    record.key = MakeValue<int>(i);
+
+    return record;
+}
+
+template<>
+std::string MakeValue<std::string>(size_t i) {
+    return "payload-that-does-not-fit-sso-" + std::to_string(MakeValue<int>(i));
+}
+
+// Uniform construction and bounded push for every container under test:
+// a bounded container overwrites its oldest element once it is full.
+template<typename Container>
+struct Adapter;
+
+template<typename T>
+struct Adapter<CircularBuffer<T>> {
+    static CircularBuffer<T> Make(size_t capacity) {
+        CircularBuffer<T> buff;
+        buff.reserve(capacity);
+
+        return buff;
+    }
+
+    static void PushBounded(CircularBuffer<T>& buff, const T& value, size_t) {
+        buff.push_back(value);
+    }
+};
+
+template<typename T>
+struct Adapter<std::deque<T>> {
+    static std::deque<T> Make(size_t) {
+        return std::deque<T>();
+    }
+
+    static void PushBounded(std::deque<T>& buff, const T& value, size_t capacity) {
+        if (buff.size() == capacity) {
+            buff.pop_front();
+        }
+
+        buff.push_back(value);
+    }
+};
+
+#ifdef CBUFFER_BENCH_HAVE_BOOST
+template<typename T>
+struct Adapter<boost::circular_buffer<T>> {
+    static boost::circular_buffer<T> Make(size_t capacity) {
+        return boost::circular_buffer<T>(capacity);
+    }
+
+    static void PushBounded(boost::circular_buffer<T>& buff, const T& value, size_t) {
+        buff.push_back(value);
+    }
+};
+#endif
+
+template<typename Container>
+Container MakeFilled(size_t capacity, size_t size) {
+    using T = typename Container::value_type;
+
+    Container buff = Adapter<Container>::Make(capacity);
+
+    // Push past the capacity first so the ring is wrapped like in steady state.
+    for (size_t i = 0; i < capacity + size; ++i) {
+        Adapter<Container>::PushBounded(buff, MakeValue<T>(i), capacity);
+    }
+
+    while (buff.size() > size) {
+        buff.pop_front();
+    }
+
+    return buff;
+}
+
+} // namespace
+
+template<typename Container>
+static void BM_PushPopSteady(benchmark::State& state) {
+    using T = typename Container::value_type;
+
+    Container buff = MakeFilled<Container>(kSize, kSize / 2);
+    T value = MakeValue<T>(1);
+
+    for (auto _ : state) {
+        buff.push_back(value);
+        benchmark::DoNotOptimize(buff.front());
+        buff.pop_front();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+static void BM_OverwriteFull(benchmark::State& state) {
+    using T = typename Container::value_type;
+
+    Container buff = MakeFilled<Container>(kSize, kSize);
+    T value = MakeValue<T>(1);
+
+    for (auto _ : state) {
+        Adapter<Container>::PushBounded(buff, value, kSize);
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+static void BM_RandomAccess(benchmark::State& state) {
+    Container buff = MakeFilled<Container>(kSize, kSize);
+
+    std::vector<size_t> indices(kSize);
+    std::mt19937 rng(42);
+
+    for (auto& index : indices) {
+        index = rng() % kSize;
+    }
+
+    for (auto _ : state) {
+        for (size_t index : indices) {
+            benchmark::DoNotOptimize(buff[index]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+static void BM_IteratorTraversal(benchmark::State& state) {
+    Container buff = MakeFilled<Container>(kSize, kSize);
+
+    for (auto _ : state) {
+        for (const auto& value : buff) {
+            benchmark::DoNotOptimize(value);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+static void BM_Sort(benchmark::State& state) {
+    Container source = MakeFilled<Container>(kSize, kSize);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container buff = source;
+        state.ResumeTiming();
+
+        std::sort(buff.begin(), buff.end());
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+template<typename Container>
+static void BM_InsertEraseMiddle(benchmark::State& state) {
+    using T = typename Container::value_type;
+
+    Container buff = MakeFilled<Container>(kSize, kSize / 2);
+    T value = MakeValue<T>(1);
+
+    for (auto _ : state) {
+        buff.insert(buff.begin() + buff.size() / 2, value);
+        buff.erase(buff.begin() + buff.size() / 2);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Order-book style edits at uniformly random positions: shifting the
+// shorter side moves n/4 elements on average instead of n/2.
+template<typename Container>
+static void BM_InsertEraseRandom(benchmark::State& state) {
+    using T = typename Container::value_type;
+
+    Container buff = MakeFilled<Container>(kSize, kSize / 2);
+    T value = MakeValue<T>(1);
+    std::mt19937 rng(42);
+
+    for (auto _ : state) {
+        size_t index = rng() % buff.size();
+
+        buff.insert(buff.begin() + index, value);
+        buff.erase(buff.begin() + index);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template<typename Container>
+static void BM_Growth(benchmark::State& state) {
+    using T = typename Container::value_type;
+
+    T value = MakeValue<T>(1);
+
+    for (auto _ : state) {
+        Container buff;
+
+        for (size_t i = 0; i < kSize; ++i) {
+            buff.push_back(value);
+        }
+
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kSize);
+}
+
+#define CBUFFER_BENCH_FOR_TYPE(Bench, T)                     \
+    BENCHMARK_TEMPLATE(Bench, CircularBuffer<T>);            \
+    BENCHMARK_TEMPLATE(Bench, std::deque<T>)
+
+#ifdef CBUFFER_BENCH_HAVE_BOOST
+#define CBUFFER_BENCH(Bench)                                 \
+    CBUFFER_BENCH_FOR_TYPE(Bench, int);                      \
+    BENCHMARK_TEMPLATE(Bench, boost::circular_buffer<int>);  \
+    CBUFFER_BENCH_FOR_TYPE(Bench, Record);                   \
+    BENCHMARK_TEMPLATE(Bench, boost::circular_buffer<Record>); \
+    CBUFFER_BENCH_FOR_TYPE(Bench, std::string);              \
+    BENCHMARK_TEMPLATE(Bench, boost::circular_buffer<std::string>)
+#else
+#define CBUFFER_BENCH(Bench)                                 \
+    CBUFFER_BENCH_FOR_TYPE(Bench, int);                      \
+    CBUFFER_BENCH_FOR_TYPE(Bench, Record);                   \
+    CBUFFER_BENCH_FOR_TYPE(Bench, std::string)
+#endif
+
+CBUFFER_BENCH(BM_PushPopSteady);
+CBUFFER_BENCH(BM_OverwriteFull);
+CBUFFER_BENCH(BM_RandomAccess);
+CBUFFER_BENCH(BM_IteratorTraversal);
+CBUFFER_BENCH(BM_Sort);
+CBUFFER_BENCH(BM_InsertEraseMiddle);
+CBUFFER_BENCH(BM_InsertEraseRandom);
+
+BENCHMARK_TEMPLATE(BM_Growth, CircularBufferExt<int>);
+BENCHMARK_TEMPLATE(BM_Growth, std::deque<int>);
+BENCHMARK_TEMPLATE(BM_Growth, std::vector<int>);
+BENCHMARK_TEMPLATE(BM_Growth, CircularBufferExt<Record>);
+BENCHMARK_TEMPLATE(BM_Growth, std::deque<Record>);
+BENCHMARK_TEMPLATE(BM_Growth, std::vector<Record>);
+BENCHMARK_TEMPLATE(BM_Growth, CircularBufferExt<std::string>);
+BENCHMARK_TEMPLATE(BM_Growth, std::deque<std::string>);
+BENCHMARK_TEMPLATE(BM_Growth, std::vector<std::string>);
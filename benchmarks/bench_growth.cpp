@@ -0,0 +1,145 @@
+#include "../include/circular_buffer.h"
+#include "../include/segmented_circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Amortized cost of growing an unbounded buffer from empty to range(1)
+// elements; range(0) is the growth factor times ten.
+static void BM_ExtPushBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(1);
+
+    for (auto _ : state) {
+        CircularBufferExt<int> buff;
+        buff.set_growth_factor(state.range(0) / 10.0);
+
+        for (size_t i = 0; i < n; ++i) {
+            buff.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(buff.back());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Same, but the ring is wrapped when every reallocation happens, so both
+// runs have to be relocated.
+static void BM_ExtPushFrontGrowth(benchmark::State& state) {
+    const size_t n = state.range(1);
+
+    for (auto _ : state) {
+        CircularBufferExt<int> buff;
+        buff.set_growth_factor(state.range(0) / 10.0);
+
+        for (size_t i = 0; i < n; ++i) {
+            buff.push_front(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(buff.front());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_ExtStringPushBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(1);
+    const std::string value(32, 'x');
+
+    for (auto _ : state) {
+        CircularBufferExt<std::string> buff;
+        buff.set_growth_factor(state.range(0) / 10.0);
+
+        for (size_t i = 0; i < n; ++i) {
+            buff.push_back(value);
+        }
+
+        benchmark::DoNotOptimize(buff.back());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_VectorPushBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(1);
+
+    for (auto _ : state) {
+        std::vector<int> vec;
+
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(vec.back());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_SegmentedPushBackGrowth(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        SegmentedCircularBuffer<int> buff;
+
+        for (size_t i = 0; i < n; ++i) {
+            buff.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(buff.back());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Longest single push_back while growing to range(0) elements: a full copy
+// of the array for CircularBufferExt, one chunk allocation for
+// SegmentedCircularBuffer.
+template<typename Buffer>
+static void BM_WorstPushBackLatency(benchmark::State& state) {
+    const size_t n = state.range(0);
+    double worst_ns = 0;
+
+    for (auto _ : state) {
+        Buffer buff;
+
+        for (size_t i = 0; i < n; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            buff.push_back(static_cast<int>(i));
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            worst_ns = std::max(worst_ns, elapsed.count());
+        }
+
+        benchmark::DoNotOptimize(buff.back());
+    }
+
+    state.counters["worst_push_ns"] = worst_ns;
+}
+
+BENCHMARK(BM_ExtPushBackGrowth)
+    ->ArgsProduct({{15, 20}, {1 << 10, 1 << 20, 100'000'000}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ExtPushFrontGrowth)
+    ->ArgsProduct({{15, 20}, {1 << 10, 1 << 20, 100'000'000}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ExtStringPushBackGrowth)
+    ->ArgsProduct({{15, 20}, {1 << 10, 1 << 20}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VectorPushBackGrowth)
+    ->Args({20, 100'000'000})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SegmentedPushBackGrowth)
+    ->Args({1 << 10})
+    ->Args({1 << 20})
+    ->Args({100'000'000})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_WorstPushBackLatency, CircularBufferExt<int>)
+    ->Args({1 << 24})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_WorstPushBackLatency, SegmentedCircularBuffer<int>)
+    ->Args({1 << 24})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,70 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+template<typename Indexing>
+using IntBuffer = CircularBuffer<int, std::allocator<int>, Indexing>;
+
+template<typename Indexing>
+static void BM_PushBackOverwrite(benchmark::State& state) {
+    IntBuffer<Indexing> buff;
+    buff.reserve(state.range(0));
+
+    int value = 0;
+
+    for (auto _ : state) {
+        buff.push_back(++value);
+        benchmark::DoNotOptimize(buff);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Indexing>
+static void BM_PushPop(benchmark::State& state) {
+    IntBuffer<Indexing> buff;
+    buff.reserve(state.range(0));
+
+    for (int i = 0; i < state.range(0) / 2; ++i) {
+        buff.push_back(i);
+    }
+
+    int value = 0;
+
+    for (auto _ : state) {
+        buff.push_back(++value);
+        benchmark::DoNotOptimize(buff.front());
+        buff.pop_front();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Indexing>
+static void BM_RandomAccess(benchmark::State& state) {
+    IntBuffer<Indexing> buff;
+    buff.reserve(state.range(0));
+
+    for (int i = 0; i < state.range(0) * 3 / 2; ++i) {
+        buff.push_back(i);
+    }
+
+    for (auto _ : state) {
+        int64_t sum = 0;
+
+        for (size_t i = 0; i < buff.size(); ++i) {
+            sum += buff[i];
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * buff.size());
+}
+
+BENCHMARK_TEMPLATE(BM_PushBackOverwrite, ModuloIndexing)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBackOverwrite, PowerOfTwoIndexing)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PushPop, ModuloIndexing)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PushPop, PowerOfTwoIndexing)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_RandomAccess, ModuloIndexing)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_RandomAccess, PowerOfTwoIndexing)->Arg(1 << 10)->Arg(1 << 20);
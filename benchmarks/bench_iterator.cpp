@@ -0,0 +1,108 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Iterator-heavy algorithms over a wrapped ring, with std::vector as the
+// contiguous lower bound and std::deque as the segmented reference.
+namespace {
+
+using ModuloBuffer = CircularBuffer<int>;
+using PowerOfTwoBuffer = CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing>;
+
+template<typename Container>
+Container MakeWrapped(size_t n) {
+    std::mt19937 gen(42);
+    Container container;
+
+    if constexpr (requires { container.reserve(n); container.capacity(); }) {
+        container.reserve(n);
+    }
+
+    for (size_t i = 0; i < n + n / 2; ++i) {
+        container.push_back(static_cast<int>(gen()));
+
+        if constexpr (requires { container.pop_front(); }) {
+            if (container.size() > n) {
+                container.pop_front();
+            }
+        }
+    }
+
+    if constexpr (std::is_same_v<Container, std::vector<int>>) {
+        container.erase(container.begin(), container.begin() + n / 2);
+    }
+
+    return container;
+}
+
+} // namespace
+
+template<typename Container>
+static void BM_IteratorSort(benchmark::State& state) {
+    const Container source = MakeWrapped<Container>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container container = source;
+        state.ResumeTiming();
+
+        std::sort(container.begin(), container.end());
+        benchmark::DoNotOptimize(container);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Container>
+static void BM_IteratorLowerBound(benchmark::State& state) {
+    Container container = MakeWrapped<Container>(state.range(0));
+    std::sort(container.begin(), container.end());
+
+    std::mt19937 gen(7);
+
+    for (auto _ : state) {
+        auto it = std::lower_bound(container.cbegin(), container.cend(), static_cast<int>(gen()));
+        benchmark::DoNotOptimize(it);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Container>
+static void BM_IteratorAccumulate(benchmark::State& state) {
+    const Container container = MakeWrapped<Container>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(container.begin(), container.end(), 0LL));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename Container>
+static void BM_ReverseIteratorAccumulate(benchmark::State& state) {
+    const Container container = MakeWrapped<Container>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(container.rbegin(), container.rend(), 0LL));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define ITERATOR_BENCHMARKS(Container)                                     \
+    BENCHMARK_TEMPLATE(BM_IteratorSort, Container)->Arg(1 << 16);          \
+    BENCHMARK_TEMPLATE(BM_IteratorLowerBound, Container)->Arg(1 << 20);    \
+    BENCHMARK_TEMPLATE(BM_IteratorAccumulate, Container)->Arg(1 << 16);    \
+    BENCHMARK_TEMPLATE(BM_ReverseIteratorAccumulate, Container)->Arg(1 << 16)
+
+ITERATOR_BENCHMARKS(ModuloBuffer);
+ITERATOR_BENCHMARKS(PowerOfTwoBuffer);
+ITERATOR_BENCHMARKS(std::deque<int>);
+ITERATOR_BENCHMARKS(std::vector<int>);
@@ -0,0 +1,85 @@
+#include "../include/aligned_allocator.h"
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+// Cross-core cost of false sharing. Needs at least two cores to show a
+// difference; on one core both variants measure the same thing.
+namespace {
+
+constexpr int kTransferred = 1 << 18;
+
+struct PackedSlot {
+    CircularBuffer<int> buff;
+};
+
+struct alignas(64) PaddedSlot {
+    CircularBuffer<int> buff;
+};
+
+template<typename Slot>
+Slot per_thread_buffers[2];
+
+} // namespace
+
+// A producer thread streams kTransferred ints to the benchmark thread. With
+// PackedLayout every push invalidates the line the consumer polls.
+template<typename Layout>
+static void BM_SpscTransfer(benchmark::State& state) {
+    for (auto _ : state) {
+        SpscCircularBuffer<int, AlignedAllocator<int>, Layout> buff(1024);
+
+        std::thread producer([&buff]() {
+            for (int i = 0; i < kTransferred; ++i) {
+                Backoff backoff;
+
+                while (!buff.try_push(i)) {
+                    backoff.Pause();
+                }
+            }
+        });
+
+        int value = 0;
+
+        for (int i = 0; i < kTransferred; ++i) {
+            Backoff backoff;
+
+            while (!buff.try_pop(value)) {
+                backoff.Pause();
+            }
+        }
+
+        benchmark::DoNotOptimize(value);
+        producer.join();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kTransferred);
+}
+
+// Two threads, each with a private CircularBuffer. Packed, both buffer
+// objects share one cache line and every push/pop bounces it between cores.
+template<typename Slot>
+static void BM_PerThreadBuffers(benchmark::State& state) {
+    CircularBuffer<int>& buff = per_thread_buffers<Slot>[state.thread_index()].buff;
+
+    if (buff.capacity() == 0) {
+        buff.reserve(64);
+    }
+
+    int value = 0;
+
+    for (auto _ : state) {
+        buff.push_back(++value);
+        buff.pop_front();
+    }
+
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_SpscTransfer, CacheLineLayout)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SpscTransfer, PackedLayout)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PerThreadBuffers, PaddedSlot)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PerThreadBuffers, PackedSlot)->Threads(2)->UseRealTime();
@@ -0,0 +1,51 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+
+static MpmcCircularBuffer<int> mpmc_buffer(1024);
+
+static CircularBuffer<int> locked_buffer;
+static std::mutex locked_buffer_mutex;
+
+// Every thread pushes one element and pops one back, so the ring never
+// runs dry and the measured cost is the contention on head and tail.
+static void BM_MpmcPushPop(benchmark::State& state) {
+    int value = 0;
+
+    for (auto _ : state) {
+        mpmc_buffer.push_wait(value);
+        mpmc_buffer.pop_wait(value);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+static void BM_MutexPushPop(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        std::lock_guard<std::mutex> lock(locked_buffer_mutex);
+        locked_buffer.reserve(1024);
+    }
+
+    int value = 0;
+
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> lock(locked_buffer_mutex);
+            locked_buffer.push_back(value);
+        }
+
+        std::lock_guard<std::mutex> lock(locked_buffer_mutex);
+
+        if (!locked_buffer.empty()) {
+            value = locked_buffer.front();
+            locked_buffer.pop_front();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_MpmcPushPop)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_MutexPushPop)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,187 @@
+#include "../include/circular_buffer.h"
+#include "../include/circular_buffer_simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+
+// A wrapped telemetry window reduced through BufferIterator (the scalar
+// loop users write today) against cb::simd. The ISA benchmarks pin one
+// kernel set to show what each instruction set contributes.
+namespace {
+
+constexpr size_t kWindow = 4096;
+
+template<typename T>
+CircularBuffer<T> MakeWindow() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    CircularBuffer<T> buff;
+    buff.reserve(kWindow);
+
+    for (size_t i = 0; i < kWindow + kWindow / 3; ++i) {
+        buff.push_back(static_cast<T>(dist(gen)));
+    }
+
+    return buff;
+}
+
+} // namespace
+
+template<typename T>
+static void BM_IteratorSum(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(buff.begin(), buff.end(), T(0)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_SimdSum(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::simd::sum(buff));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_IteratorMinMax(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        auto [min, max] = std::minmax_element(buff.begin(), buff.end());
+        benchmark::DoNotOptimize(*min);
+        benchmark::DoNotOptimize(*max);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_SimdMinMax(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::simd::min(buff));
+        benchmark::DoNotOptimize(cb::simd::max(buff));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_IteratorCountGreater(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+    const T threshold = T(900);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count_if(buff.begin(), buff.end(), [threshold](T x) { return x > threshold; }));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_SimdCountGreater(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::simd::count_greater(buff, T(900)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_IteratorFind(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(buff.begin(), buff.end(), T(-1)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_SimdFind(benchmark::State& state) {
+    const CircularBuffer<T> buff = MakeWindow<T>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::simd::find(buff, T(-1)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_IteratorDot(benchmark::State& state) {
+    const CircularBuffer<T> lhs = MakeWindow<T>();
+    const CircularBuffer<T> rhs(lhs.begin(), lhs.end());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::inner_product(lhs.begin(), lhs.end(), rhs.begin(), T(0)));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+template<typename T>
+static void BM_SimdDot(benchmark::State& state) {
+    const CircularBuffer<T> lhs = MakeWindow<T>();
+    const CircularBuffer<T> rhs(lhs.begin(), lhs.end());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cb::simd::dot(lhs, rhs));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+// range(0) is a cb::simd::Isa.
+template<typename T>
+static void BM_IsaSum(benchmark::State& state) {
+    auto isa = static_cast<cb::simd::Isa>(state.range(0));
+
+    if (!cb::simd::is_supported(isa)) {
+        state.SkipWithError("Instruction set is not supported.");
+        return;
+    }
+
+    const CircularBuffer<T> buff = MakeWindow<T>();
+    const auto& k = cb::simd::kernels<T>(isa);
+
+    for (auto _ : state) {
+        auto first = buff.array_one();
+        auto second = buff.array_two();
+        benchmark::DoNotOptimize(k.sum(first.data(), first.size()) + k.sum(second.data(), second.size()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kWindow);
+}
+
+#define SIMD_BENCHMARKS(T)                                \
+    BENCHMARK_TEMPLATE(BM_IteratorSum, T);                \
+    BENCHMARK_TEMPLATE(BM_SimdSum, T);                    \
+    BENCHMARK_TEMPLATE(BM_IteratorMinMax, T);             \
+    BENCHMARK_TEMPLATE(BM_SimdMinMax, T);                 \
+    BENCHMARK_TEMPLATE(BM_IteratorCountGreater, T);       \
+    BENCHMARK_TEMPLATE(BM_SimdCountGreater, T);           \
+    BENCHMARK_TEMPLATE(BM_IteratorFind, T);               \
+    BENCHMARK_TEMPLATE(BM_SimdFind, T);                   \
+    BENCHMARK_TEMPLATE(BM_IteratorDot, T);                \
+    BENCHMARK_TEMPLATE(BM_SimdDot, T);                    \
+    BENCHMARK_TEMPLATE(BM_IsaSum, T)->DenseRange(0, 3)
+
+SIMD_BENCHMARKS(float);
+SIMD_BENCHMARKS(double);
+SIMD_BENCHMARKS(std::int64_t);
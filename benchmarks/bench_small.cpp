@@ -0,0 +1,49 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// Many tiny growable queues, e.g. the last few events kept per key. Most of
+// them never outgrow a handful of elements, so inline storage saves an
+// allocation per queue and keeps the elements next to the queue header.
+namespace {
+
+constexpr int kQueues = 1024;
+
+template<typename Buffer>
+void FillQueues(benchmark::State& state) {
+    int length = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        std::vector<Buffer> queues(kQueues);
+
+        for (int i = 0; i < length; ++i) {
+            for (Buffer& queue : queues) {
+                queue.push_back(i);
+            }
+        }
+
+        long long sum = 0;
+
+        for (const Buffer& queue : queues) {
+            sum += queue.front() + queue.back();
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kQueues * length);
+}
+
+} // namespace
+
+static void BM_TinyQueuesHeap(benchmark::State& state) {
+    FillQueues<CircularBufferExt<int>>(state);
+}
+BENCHMARK(BM_TinyQueuesHeap)->Arg(4)->Arg(8)->Arg(32);
+
+static void BM_TinyQueuesInline(benchmark::State& state) {
+    FillQueues<SmallCircularBuffer<int, 8>>(state);
+}
+BENCHMARK(BM_TinyQueuesInline)->Arg(4)->Arg(8)->Arg(32);
@@ -0,0 +1,59 @@
+#include "../include/circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr size_t kCapacity = 1 << 10;
+
+// NoStats is the default, so this is the plain CircularBuffer<int>.
+using NoStatsBuffer = CircularBuffer<int, std::allocator<int>, ModuloIndexing, NoStats>;
+using CountingBuffer = CircularBuffer<int, std::allocator<int>, ModuloIndexing, CountingStats<int>>;
+
+// Steady push/pop at half capacity: the hooks on every operation.
+template<typename Buffer>
+void BM_StatsPushPop(benchmark::State& state) {
+    Buffer buffer;
+    buffer.reserve(kCapacity);
+
+    for (size_t i = 0; i < kCapacity / 2; ++i) {
+        buffer.push_back(static_cast<int>(i));
+    }
+
+    int value = 0;
+
+    for (auto _ : state) {
+        buffer.push_back(++value);
+        benchmark::DoNotOptimize(buffer.front());
+        buffer.pop_front();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// A full buffer: every push also reports an overwrite.
+template<typename Buffer>
+void BM_StatsOverwrite(benchmark::State& state) {
+    Buffer buffer;
+    buffer.reserve(kCapacity);
+
+    for (size_t i = 0; i < kCapacity; ++i) {
+        buffer.push_back(static_cast<int>(i));
+    }
+
+    int value = 0;
+
+    for (auto _ : state) {
+        buffer.push_back(++value);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_StatsPushPop, NoStatsBuffer);
+BENCHMARK_TEMPLATE(BM_StatsPushPop, CountingBuffer);
+BENCHMARK_TEMPLATE(BM_StatsOverwrite, NoStatsBuffer);
+BENCHMARK_TEMPLATE(BM_StatsOverwrite, CountingBuffer);
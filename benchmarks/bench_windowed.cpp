@@ -0,0 +1,68 @@
+#include "../include/windowed_circular_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Cost of one sample in a moving mean/min/max: incremental aggregates
+// against recomputing the window on every push.
+namespace {
+
+std::vector<double> MakeSamples() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 100.0);
+    std::vector<double> samples(1 << 12);
+
+    for (auto& sample : samples) {
+        sample = dist(gen);
+    }
+
+    return samples;
+}
+
+} // namespace
+
+static void BM_MovingStatisticsIncremental(benchmark::State& state) {
+    const std::vector<double> samples = MakeSamples();
+    MovingStatistics<double> window(state.range(0));
+    size_t i = 0;
+
+    for (auto _ : state) {
+        window.push_back(samples[i++ & (samples.size() - 1)]);
+        benchmark::DoNotOptimize(window.mean());
+        benchmark::DoNotOptimize(window.variance());
+        benchmark::DoNotOptimize(window.min());
+        benchmark::DoNotOptimize(window.max());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_MovingStatisticsRecompute(benchmark::State& state) {
+    const std::vector<double> samples = MakeSamples();
+    CircularBuffer<double> window;
+    window.reserve(state.range(0));
+    size_t i = 0;
+
+    for (auto _ : state) {
+        window.push_back(samples[i++ & (samples.size() - 1)]);
+
+        double n = window.size();
+        double mean = cb::accumulate(window, 0.0) / n;
+        double squares = cb::accumulate(window, 0.0, [](double acc, double x) { return acc + x * x; });
+        auto [min, max] = std::minmax_element(window.begin(), window.end());
+
+        benchmark::DoNotOptimize(mean);
+        benchmark::DoNotOptimize(squares / n - mean * mean);
+        benchmark::DoNotOptimize(*min);
+        benchmark::DoNotOptimize(*max);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MovingStatisticsIncremental)->Arg(64)->Arg(1 << 12)->Arg(1 << 16);
+BENCHMARK(BM_MovingStatisticsRecompute)->Arg(64)->Arg(1 << 12)->Arg(1 << 16);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// Allocator that places every block on an `Alignment` boundary, so ring
+// storage starts on a cache line and no slot straddles two lines more often
+// than its size requires. Pass it as the Allocator of any buffer here:
+// CircularBuffer<T, AlignedAllocator<T>>.
+template<typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+public:
+    using value_type       = T;
+    using size_type        = std::size_t;
+    using difference_type  = std::ptrdiff_t;
+
+    static constexpr std::size_t kAlignment = std::max(Alignment, alignof(T));
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+public:
+    AlignedAllocator() = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+    {}
+public:
+    T* allocate(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+    }
+
+    void deallocate(T* p, size_type n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t(kAlignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+};
+
+// Cache-line aligned for small blocks. Blocks of at least kHugePageSize are
+// aligned and padded to whole 2 MiB pages and, on Linux, advised as
+// transparent huge pages, which cuts TLB misses when a large ring is
+// streamed through.
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type       = T;
+    using size_type        = std::size_t;
+    using difference_type  = std::ptrdiff_t;
+
+    static constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+    static constexpr std::size_t kSmallAlignment = std::max<std::size_t>(64, alignof(T));
+
+    template<typename U>
+    struct rebind {
+        using other = HugePageAllocator<U>;
+    };
+public:
+    HugePageAllocator() = default;
+
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept
+    {}
+public:
+    T* allocate(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T) - kHugePageSize) {
+            throw std::bad_array_new_length();
+        }
+
+        size_type bytes = n * sizeof(T);
+
+        if (bytes < kHugePageSize) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(kSmallAlignment)));
+        }
+
+        bytes = RoundUp(bytes);
+        void* p = ::operator new(bytes, std::align_val_t(kHugePageSize));
+
+#ifdef __linux__
+        // Only a hint; without THP support the block stays on small pages.
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_type n) noexcept {
+        size_type bytes = n * sizeof(T);
+
+        if (bytes < kHugePageSize) {
+            ::operator delete(p, bytes, std::align_val_t(kSmallAlignment));
+        } else {
+            ::operator delete(p, RoundUp(bytes), std::align_val_t(kHugePageSize));
+        }
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept {
+        return true;
+    }
+private:
+    static size_type RoundUp(size_type bytes) {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+};
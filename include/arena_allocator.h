@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+// Fixed slab carved into power-of-two blocks from 64 bytes up. Freed blocks
+// go to a per-size free list and are reused by the next request of the same
+// size class, so a steady churn of short-lived buffers never reaches malloc
+// after warm-up. Blocks are aligned to their size (up to a page). When the
+// slab runs out allocate throws std::bad_alloc instead of falling back to
+// the heap. Not thread-safe: give each thread its own arena.
+//
+// FixedArena is a std::pmr::memory_resource, so it works with
+// cb::pmr::CircularBuffer; ArenaAllocator<T> is the non-polymorphic way in.
+class FixedArena final : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kMinBlockSize = 64;
+    static constexpr std::size_t kMaxBlockAlignment = 4096;
+public:
+    // Owns a slab of `bytes` bytes.
+    explicit FixedArena(std::size_t bytes)
+        : slab_(static_cast<std::byte*>(::operator new(bytes, std::align_val_t(kMaxBlockAlignment))))
+        , size_(bytes)
+        , used_(0)
+        , owns_slab_(true)
+    {
+        free_lists_.fill(nullptr);
+    }
+
+    // Uses caller-provided memory, for instance a static or stack array.
+    FixedArena(void* buffer, std::size_t bytes)
+        : slab_(static_cast<std::byte*>(buffer))
+        , size_(bytes)
+        , used_(0)
+        , owns_slab_(false)
+    {
+        free_lists_.fill(nullptr);
+    }
+
+    FixedArena(const FixedArena&) = delete;
+    FixedArena& operator=(const FixedArena&) = delete;
+
+    ~FixedArena() override {
+        if (owns_slab_) {
+            ::operator delete(slab_, size_, std::align_val_t(kMaxBlockAlignment));
+        }
+    }
+public:
+    std::size_t capacity() const {
+        return size_;
+    }
+
+    // Bytes of the slab handed out at least once; freed blocks stay counted.
+    std::size_t used() const {
+        return used_;
+    }
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        // Checked before rounding: nothing larger than the slab can be
+        // served, and bit_ceil past the top bit is undefined.
+        if (alignment > kMaxBlockAlignment || bytes > size_ || alignment > size_) {
+            throw std::bad_alloc();
+        }
+
+        std::size_t block = BlockSize(bytes, alignment);
+        FreeBlock*& head = free_lists_[SizeClass(block)];
+
+        if (head != nullptr) {
+            FreeBlock* reused = head;
+            head = reused->next;
+
+            return reused;
+        }
+
+        std::size_t block_alignment = std::min(block, kMaxBlockAlignment);
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(slab_);
+        std::size_t offset = ((base + used_ + block_alignment - 1) & ~(block_alignment - 1)) - base;
+
+        if (offset > size_ || size_ - offset < block) {
+            throw std::bad_alloc();
+        }
+
+        used_ = offset + block;
+
+        return slab_ + offset;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        FreeBlock*& head = free_lists_[SizeClass(BlockSize(bytes, alignment))];
+
+        head = ::new (p) FreeBlock{head};
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static std::size_t BlockSize(std::size_t bytes, std::size_t alignment) {
+        return std::bit_ceil(std::max({bytes, alignment, kMinBlockSize}));
+    }
+
+    static std::size_t SizeClass(std::size_t block) {
+        return std::countr_zero(block / kMinBlockSize);
+    }
+private:
+    std::byte* slab_;
+    std::size_t size_;
+    std::size_t used_;
+    bool owns_slab_;
+    std::array<FreeBlock*, 64> free_lists_;
+};
+
+// Stateful allocator over a FixedArena. Copies share the arena and compare
+// equal only when they point to the same one; the arena travels with the
+// buffer on copy, move and swap.
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type       = T;
+    using size_type        = std::size_t;
+    using difference_type  = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+public:
+    ArenaAllocator(FixedArena& arena) noexcept
+        : arena_(&arena)
+    {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.arena())
+    {}
+public:
+    T* allocate(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_type n) noexcept {
+        arena_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    FixedArena* arena() const noexcept {
+        return arena_;
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+private:
+    FixedArena* arena_;
+};
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <concepts>
+#include <coroutine>
+#include <optional>
+
+// Anything that can schedule a suspended coroutine to be resumed later.
+template<typename E>
+concept CoroutineExecutor = requires(E& executor, std::coroutine_handle<> handle) {
+    executor.post(handle);
+};
+
+// Run queue drained by whichever thread calls run(). One executor per core
+// with every coroutine of a pipeline posted to it is enough to multiplex
+// thousands of pipelines without a thread each. Not thread-safe: post from
+// the thread that runs it.
+class SingleThreadExecutor {
+public:
+    void post(std::coroutine_handle<> handle) {
+        ready_.push_back(handle);
+    }
+
+    // Resumes one queued coroutine. Returns false if there was none.
+    bool run_one() {
+        if (ready_.empty()) {
+            return false;
+        }
+
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+        handle.resume();
+
+        return true;
+    }
+
+    // Resumes coroutines until none is ready, including the ones posted
+    // while running. Returns the number of resumptions.
+    std::size_t run() {
+        std::size_t resumed = 0;
+
+        while (run_one()) {
+            ++resumed;
+        }
+
+        return resumed;
+    }
+
+    std::size_t pending() const {
+        return ready_.size();
+    }
+private:
+    CircularBufferExt<std::coroutine_handle<>> ready_;
+};
+
+namespace cb::detail {
+
+// FIFO of awaiters linked through their own `next_` member, so suspending
+// never allocates.
+template<typename Node>
+class IntrusiveQueue {
+public:
+    bool empty() const {
+        return head_ == nullptr;
+    }
+
+    void push_back(Node* node) {
+        node->next_ = nullptr;
+
+        if (tail_ == nullptr) {
+            head_ = node;
+        } else {
+            tail_->next_ = node;
+        }
+
+        tail_ = node;
+    }
+
+    Node* pop_front() {
+        Node* node = head_;
+        head_ = node->next_;
+
+        if (head_ == nullptr) {
+            tail_ = nullptr;
+        }
+
+        return node;
+    }
+private:
+    Node* head_ = nullptr;
+    Node* tail_ = nullptr;
+};
+
+} // namespace cb::detail
+
+// Bounded channel for coroutines over CircularBuffer:
+//
+//     bool ok = co_await channel.push(value);          // false once closed
+//     std::optional<T> value = co_await channel.pop(); // nullopt once closed and drained
+//
+// A push into a full buffer and a pop from an empty one suspend the caller
+// in an intrusive wait list kept inside the awaiter; the matching operation
+// on the other side completes it and hands the coroutine to the executor.
+// A value pushed while a consumer is waiting goes straight to that consumer.
+//
+// There is no locking: every coroutine using one channel must run on the
+// same single-threaded executor (or otherwise be serialized). Awaiters
+// must not be destroyed while suspended, and the channel must outlive them.
+template<
+    typename T,
+    CoroutineExecutor Executor = SingleThreadExecutor,
+    typename Allocator = std::allocator<T>
+>
+class AsyncCircularBuffer {
+public:
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type   = Allocator;
+    using executor_type    = Executor;
+public:
+    class PushAwaiter {
+    public:
+        bool await_ready() {
+            return channel_->TryCompletePush(*this);
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            handle_ = handle;
+            channel_->producers_.push_back(this);
+        }
+
+        bool await_resume() const {
+            return pushed_;
+        }
+    private:
+        friend class AsyncCircularBuffer;
+        friend class cb::detail::IntrusiveQueue<PushAwaiter>;
+
+        template<typename U>
+        PushAwaiter(AsyncCircularBuffer* channel, U&& value)
+            : channel_(channel)
+            , value_(std::forward<U>(value))
+        {}
+    private:
+        AsyncCircularBuffer* channel_;
+        value_type value_;
+        bool pushed_ = false;
+        std::coroutine_handle<> handle_;
+        PushAwaiter* next_ = nullptr;
+    };
+
+    class PopAwaiter {
+    public:
+        bool await_ready() {
+            return channel_->TryCompletePop(*this);
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            handle_ = handle;
+            channel_->consumers_.push_back(this);
+        }
+
+        std::optional<value_type> await_resume() {
+            return std::move(value_);
+        }
+    private:
+        friend class AsyncCircularBuffer;
+        friend class cb::detail::IntrusiveQueue<PopAwaiter>;
+
+        explicit PopAwaiter(AsyncCircularBuffer* channel)
+            : channel_(channel)
+        {}
+    private:
+        AsyncCircularBuffer* channel_;
+        std::optional<value_type> value_;
+        std::coroutine_handle<> handle_;
+        PopAwaiter* next_ = nullptr;
+    };
+public:
+    AsyncCircularBuffer(size_type capacity, Executor& executor, const Allocator& alloc = Allocator())
+        : buffer_(alloc)
+        , executor_(&executor)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity must be positive.");
+        }
+
+        buffer_.reserve(capacity);
+    }
+
+    AsyncCircularBuffer(const AsyncCircularBuffer&) = delete;
+    AsyncCircularBuffer& operator=(const AsyncCircularBuffer&) = delete;
+public:
+    [[nodiscard]] PushAwaiter push(const_reference value) {
+        return PushAwaiter(this, value);
+    }
+
+    [[nodiscard]] PushAwaiter push(value_type&& value) {
+        return PushAwaiter(this, std::move(value));
+    }
+
+    [[nodiscard]] PopAwaiter pop() {
+        return PopAwaiter(this);
+    }
+
+    // Fails every suspended push, resumes every suspended pop with nullopt
+    // and makes later pushes fail at once. Buffered values can still be
+    // popped.
+    void close() {
+        closed_ = true;
+
+        while (!producers_.empty()) {
+            executor_->post(producers_.pop_front()->handle_);
+        }
+
+        while (!consumers_.empty()) {
+            executor_->post(consumers_.pop_front()->handle_);
+        }
+    }
+public:
+    bool closed() const {
+        return closed_;
+    }
+
+    size_type size() const {
+        return buffer_.size();
+    }
+
+    bool empty() const {
+        return buffer_.empty();
+    }
+
+    size_type capacity() const {
+        return buffer_.capacity();
+    }
+
+    Executor& executor() const {
+        return *executor_;
+    }
+
+    allocator_type get_allocator() const {
+        return buffer_.get_allocator();
+    }
+private:
+    // Producers wait only while the buffer is full and consumers only while
+    // it is empty, so at most one of the two lists is non-empty.
+    bool TryCompletePush(PushAwaiter& push) {
+        if (closed_) {
+            return true;
+        }
+
+        if (!consumers_.empty()) {
+            PopAwaiter* consumer = consumers_.pop_front();
+            consumer->value_.emplace(std::move(push.value_));
+            executor_->post(consumer->handle_);
+        } else if (buffer_.size() < buffer_.capacity()) {
+            buffer_.push_back(std::move(push.value_));
+        } else {
+            return false;
+        }
+
+        push.pushed_ = true;
+
+        return true;
+    }
+
+    bool TryCompletePop(PopAwaiter& pop) {
+        if (buffer_.empty()) {
+            return closed_;
+        }
+
+        pop.value_.emplace(std::move(buffer_.front()));
+        buffer_.pop_front();
+
+        // The freed slot goes to the longest waiting producer.
+        if (!producers_.empty()) {
+            PushAwaiter* producer = producers_.pop_front();
+            buffer_.push_back(std::move(producer->value_));
+            producer->pushed_ = true;
+            executor_->post(producer->handle_);
+        }
+
+        return true;
+    }
+private:
+    CircularBuffer<T, Allocator> buffer_;
+    Executor* executor_;
+    cb::detail::IntrusiveQueue<PushAwaiter> producers_;
+    cb::detail::IntrusiveQueue<PopAwaiter> consumers_;
+    bool closed_ = false;
+};
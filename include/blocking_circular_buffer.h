@@ -0,0 +1,392 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+
+// Bounded producer/consumer queue over CircularBuffer guarded by one mutex.
+// push blocks while the buffer is full, pop while it is empty; the timed
+// variants give up after a timeout and close() wakes everybody for shutdown.
+//
+// Wakeups are batched: a consumer sleeps only on an empty buffer and, once
+// asleep, is signalled when `wake_threshold` elements have piled up. Only
+// the push that reaches the threshold signals, and only if a consumer is
+// actually asleep. Below the threshold a sleeper still gets the elements
+// after at most `linger`: with a threshold above 1 it wakes on its own that
+// often and takes whatever is there, so no element waits unboundedly.
+// flush() and close() hand them out at once. A consumer that leaves at
+// least a threshold of elements behind passes the signal on to the next
+// sleeping consumer. Producers are woken on the full to non-full edge.
+template<
+    typename T,
+    typename Allocator = std::allocator<T>
+>
+class BlockingCircularBuffer {
+public:
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type   = Allocator;
+public:
+    static constexpr std::chrono::microseconds kDefaultLinger = std::chrono::milliseconds(1);
+public:
+    // With the default threshold of 1 consumers are signalled on the empty
+    // to non-empty transition and `linger` is unused. The threshold is
+    // clamped to [1, capacity], so a full buffer always wakes its consumers.
+    explicit BlockingCircularBuffer(
+        size_type capacity,
+        size_type wake_threshold = 1,
+        std::chrono::microseconds linger = kDefaultLinger,
+        const Allocator& alloc = Allocator()
+    )
+        : buffer_(alloc)
+        , wake_threshold_(std::clamp<size_type>(wake_threshold, 1, std::max<size_type>(capacity, 1)))
+        , linger_(linger)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity must be positive.");
+        }
+
+        buffer_.reserve(capacity);
+    }
+
+    BlockingCircularBuffer(const BlockingCircularBuffer&) = delete;
+    BlockingCircularBuffer& operator=(const BlockingCircularBuffer&) = delete;
+public:
+    // All of these return false once the buffer is closed.
+    bool push(const_reference value) {
+        return emplace(value);
+    }
+
+    bool push(value_type&& value) {
+        return emplace(std::move(value));
+    }
+
+    template<typename... Args>
+    bool emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        WaitWhileFull(lock);
+
+        return EmplaceLocked(lock, std::forward<Args>(args)...);
+    }
+
+    bool try_push(const_reference value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(value_type&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        return EmplaceLocked(lock, std::forward<Args>(args)...);
+    }
+
+    template<typename U, typename Rep, typename Period>
+    bool push_for(U&& value, const std::chrono::duration<Rep, Period>& timeout) {
+        return push_until(std::forward<U>(value), std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<typename U, typename Clock, typename Duration>
+    bool push_until(U&& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        WaitWhileFull(lock, deadline);
+
+        return EmplaceLocked(lock, std::forward<U>(value));
+    }
+
+    // Blocks until an element is available; below the wake threshold that
+    // takes at most `linger` after it arrived. Returns false only when the
+    // buffer is closed and drained.
+    bool pop(reference out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        WaitWhileEmpty(lock);
+
+        return PopLocked(lock, out);
+    }
+
+    bool try_pop(reference out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        return PopLocked(lock, out);
+    }
+
+    template<typename Rep, typename Period>
+    bool pop_for(reference out, const std::chrono::duration<Rep, Period>& timeout) {
+        return pop_until(out, std::chrono::steady_clock::now() + timeout);
+    }
+
+    template<typename Clock, typename Duration>
+    bool pop_until(reference out, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        WaitWhileEmpty(lock, deadline);
+
+        return PopLocked(lock, out);
+    }
+
+    // Waits for at least one element, then moves up to `max_n` of them to
+    // `out` under a single lock acquisition. Returns the number moved, 0
+    // once the buffer is closed and drained.
+    template<typename OutputIterator>
+    size_type pop_batch(OutputIterator out, size_type max_n) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        WaitWhileEmpty(lock);
+
+        bool was_full = buffer_.size() == buffer_.capacity();
+        size_type n = std::min(max_n, buffer_.size());
+
+        if constexpr (std::is_same_v<OutputIterator, value_type*>) {
+            buffer_.pop_front_n(out, n);
+        } else {
+            for (size_type i = 0; i < n; ++i) {
+                *out = std::move(buffer_.front());
+                ++out;
+                buffer_.pop_front();
+            }
+        }
+
+        if (n != 0) {
+            NotifyAfterPop(lock, was_full);
+        }
+
+        return n;
+    }
+
+    // Hands whatever is buffered to sleeping consumers even if it is below
+    // the wake threshold, e.g. at the end of a burst.
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (waiting_consumers_ == 0 || buffer_.empty()) {
+            return;
+        }
+
+        ++flushes_;
+        ++wakeups_;
+        lock.unlock();
+
+        not_empty_.notify_all();
+    }
+
+    // Rejects further pushes and wakes every waiting thread. Elements
+    // already in the buffer can still be popped.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+public:
+    bool closed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    size_type size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return buffer_.size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type capacity() const {
+        return buffer_.capacity();
+    }
+
+    size_type wake_threshold() const {
+        return wake_threshold_;
+    }
+
+    std::chrono::microseconds linger() const {
+        return linger_;
+    }
+
+    // Number of notify calls issued so far, for tuning the threshold.
+    size_type wakeups() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return wakeups_;
+    }
+
+    allocator_type get_allocator() const {
+        return buffer_.get_allocator();
+    }
+private:
+    void WaitWhileFull(std::unique_lock<std::mutex>& lock) {
+        while (!closed_ && buffer_.size() == buffer_.capacity()) {
+            ++waiting_producers_;
+            not_full_.wait(lock);
+            --waiting_producers_;
+        }
+    }
+
+    template<typename Clock, typename Duration>
+    void WaitWhileFull(std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& deadline) {
+        while (!closed_ && buffer_.size() == buffer_.capacity()) {
+            ++waiting_producers_;
+            std::cv_status status = not_full_.wait_until(lock, deadline);
+            --waiting_producers_;
+
+            if (status == std::cv_status::timeout) {
+                return;
+            }
+        }
+    }
+
+    // A consumer only goes to sleep on an empty buffer; once asleep it
+    // waits for the threshold, a flush, close or its linger running out
+    // with elements present. A flush that found the buffer already drained
+    // by someone else does not count.
+    bool KeepSleeping(size_type& flushes) {
+        if (closed_) {
+            return false;
+        }
+
+        if (buffer_.empty()) {
+            flushes = flushes_;
+            return true;
+        }
+
+        return buffer_.size() < wake_threshold_ && flushes == flushes_;
+    }
+
+    void WaitWhileEmpty(std::unique_lock<std::mutex>& lock) {
+        if (closed_ || !buffer_.empty()) {
+            return;
+        }
+
+        size_type flushes = flushes_;
+
+        ++waiting_consumers_;
+
+        while (KeepSleeping(flushes)) {
+            if (wake_threshold_ == 1) {
+                not_empty_.wait(lock);
+            } else if (not_empty_.wait_for(lock, linger_) == std::cv_status::timeout && !buffer_.empty()) {
+                break;
+            }
+        }
+
+        --waiting_consumers_;
+    }
+
+    template<typename Clock, typename Duration>
+    void WaitWhileEmpty(std::unique_lock<std::mutex>& lock, const std::chrono::time_point<Clock, Duration>& deadline) {
+        if (closed_ || !buffer_.empty()) {
+            return;
+        }
+
+        size_type flushes = flushes_;
+
+        ++waiting_consumers_;
+
+        while (KeepSleeping(flushes)) {
+            if (wake_threshold_ != 1 && Clock::now() + linger_ < deadline) {
+                if (not_empty_.wait_for(lock, linger_) == std::cv_status::timeout && !buffer_.empty()) {
+                    break;
+                }
+            } else if (not_empty_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                break;
+            }
+        }
+
+        --waiting_consumers_;
+    }
+
+    // Called with the lock held after a wait; fails if the wait ended on
+    // close or on timeout with the buffer still full.
+    template<typename... Args>
+    bool EmplaceLocked(std::unique_lock<std::mutex>& lock, Args&&... args) {
+        if (closed_ || buffer_.size() == buffer_.capacity()) {
+            return false;
+        }
+
+        buffer_.emplace_back(std::forward<Args>(args)...);
+
+        size_type size = buffer_.size();
+        // Sleepers only exist while the buffer was empty, so the size passes
+        // the threshold exactly once per sleep.
+        bool wake = waiting_consumers_ != 0 && size == wake_threshold_;
+
+        // A producer that still sees room passes the wakeup on, just as
+        // consumers do below.
+        bool chain = waiting_producers_ != 0 && size != buffer_.capacity();
+
+        wakeups_ += wake + chain;
+        lock.unlock();
+
+        if (wake) {
+            not_empty_.notify_one();
+        }
+
+        if (chain) {
+            not_full_.notify_one();
+        }
+
+        return true;
+    }
+
+    bool PopLocked(std::unique_lock<std::mutex>& lock, reference out) {
+        if (buffer_.empty()) {
+            return false;
+        }
+
+        bool was_full = buffer_.size() == buffer_.capacity();
+
+        out = std::move(buffer_.front());
+        buffer_.pop_front();
+        NotifyAfterPop(lock, was_full);
+
+        return true;
+    }
+
+    // Producers are woken on the full to non-full edge; a consumer that
+    // leaves a threshold of elements behind wakes the next sleeping consumer.
+    void NotifyAfterPop(std::unique_lock<std::mutex>& lock, bool was_full) {
+        bool wake = was_full && waiting_producers_ != 0;
+        bool chain = waiting_consumers_ != 0 && buffer_.size() >= wake_threshold_;
+
+        wakeups_ += wake + chain;
+        lock.unlock();
+
+        if (wake) {
+            not_full_.notify_one();
+        }
+
+        if (chain) {
+            not_empty_.notify_one();
+        }
+    }
+private:
+    CircularBuffer<T, Allocator> buffer_;
+    size_type wake_threshold_;
+    std::chrono::microseconds linger_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+
+    size_type waiting_producers_ = 0;
+    size_type waiting_consumers_ = 0;
+    size_type wakeups_ = 0;
+    size_type flushes_ = 0;
+    bool closed_ = false;
+};
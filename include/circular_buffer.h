@@ -1,134 +1,180 @@
 #pragma once
 
+#include "circular_buffer_algorithms.h"
+#include "circular_buffer_stats.h"
+#include "circular_buffer_storage.h"
+
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Positions in the ring are abstract counters, an indexing policy turns them
+// into storage slots. ModuloIndexing keeps one spare slot to tell a full
+// buffer from an empty one and wraps positions with a compare.
+struct ModuloIndexing {
+    static constexpr bool kHasSpareSlot = true;
+
+    static constexpr std::size_t Capacity(std::size_t n) {
+        return n;
+    }
+
+    static constexpr std::size_t Slots(std::size_t capacity) {
+        return capacity + 1;
+    }
+
+    static constexpr std::size_t Slot(std::size_t pos, std::size_t) {
+        return pos;
+    }
+
+    static constexpr std::size_t Advance(std::size_t pos, std::size_t n, std::size_t slots) {
+        return pos + n >= slots ? pos + n - slots : pos + n;
+    }
+
+    static constexpr std::size_t Retreat(std::size_t pos, std::size_t n, std::size_t slots) {
+        return pos < n ? pos + slots - n : pos - n;
+    }
+};
+
+// Rounds the capacity up to a power of two and keeps free-running 64-bit
+// counters, so a slot is just `pos & mask` and no spare slot is needed.
+struct PowerOfTwoIndexing {
+    static constexpr bool kHasSpareSlot = false;
+
+    static constexpr std::size_t Capacity(std::size_t n) {
+        std::size_t capacity = 1;
+
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+
+        return n == 0 ? 0 : capacity;
+    }
+
+    static constexpr std::size_t Slots(std::size_t capacity) {
+        return capacity == 0 ? 1 : capacity;
+    }
+
+    static constexpr std::size_t Slot(std::size_t pos, std::size_t slots) {
+        return pos & (slots - 1);
+    }
+
+    static constexpr std::size_t Advance(std::size_t pos, std::size_t n, std::size_t) {
+        return pos + n;
+    }
+
+    static constexpr std::size_t Retreat(std::size_t pos, std::size_t n, std::size_t) {
+        return pos - n;
+    }
+};
 
 template<typename Buffer>
 class BufferIterator {
 public:
     using value_type        = typename Buffer::value_type;
-    using reference         = value_type&;
+    using reference         = std::conditional_t<std::is_const_v<Buffer>, const value_type&, value_type&>;
     using size_type         = typename Buffer::size_type;
-    using pointer           = value_type*;
+    using pointer           = std::conditional_t<std::is_const_v<Buffer>, const value_type*, value_type*>;
     using difference_type   = typename Buffer::difference_type;
     using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept  = std::random_access_iterator_tag;
 public:
-    BufferIterator(pointer ptr, pointer data_base, pointer data_begin, size_type size)
-        : ptr_(ptr)
-        , data_base_(data_base)
-        , data_begin_(data_begin)
-        , size_(size)
-        , position_(ptr - data_base)
+    BufferIterator()
+        : buffer_(nullptr)
+        , index_(0)
+    {}
+
+    BufferIterator(Buffer* buffer, difference_type index)
+        : buffer_(buffer)
+        , index_(index)
+    {}
+
+    // iterator -> const_iterator.
+    template<
+        typename Other,
+        typename = std::enable_if_t<std::is_const_v<Buffer> && std::is_same_v<const Other, Buffer>>
+    >
+    BufferIterator(const BufferIterator<Other>& other)
+        : buffer_(other.buffer_)
+        , index_(other.index_)
     {}
 public:
-    reference operator*() {
-        return *ptr_;
+    reference operator*() const {
+        return (*buffer_)[index_];
     }
 
-    pointer operator->() {
-        return ptr_;
+    pointer operator->() const {
+        return std::addressof((*buffer_)[index_]);
     }
 
-    reference operator[](size_type index) {
-        return *(ptr_ + index);
+    reference operator[](difference_type n) const {
+        return (*buffer_)[index_ + n];
     }
 
-    BufferIterator& operator+=(const size_type& n) {
-        *this = *this + n;
+    BufferIterator& operator+=(difference_type n) {
+        index_ += n;
         return *this;
     }
 
-    BufferIterator& operator-=(const size_type& n) {
-        *this = *this - n;
+    BufferIterator& operator-=(difference_type n) {
+        index_ -= n;
         return *this;
     }
 public:
     BufferIterator& operator++() {
-        ++ptr_;
-        ++position_;
-
-        size_type distance = ptr_ - data_base_;
-
-        if (distance == size_) {
-            ptr_ = data_base_;
-            position_ = 0;
-        }
-
+        ++index_;
         return *this;
     }
 
-    BufferIterator& operator++(int) {
+    BufferIterator operator++(int) {
         BufferIterator iterator = *this;
-        ++(*this);
+        ++index_;
 
         return iterator;
     }
 
     BufferIterator& operator--() {
-        --ptr_;
-        --position_;
-
-        int64_t distance = ptr_ - data_base_;
-
-        if (distance == -1) {
-            ptr_ = data_base_ + size_;
-            position_ = size_;
-        }
-
+        --index_;
         return *this;
     }
 
-    BufferIterator& operator--(int) {
+    BufferIterator operator--(int) {
         BufferIterator iterator = *this;
-        --(*this);
+        --index_;
 
         return iterator;
     }
 
-    BufferIterator operator+(size_type n) const {
-        n %= size_;
-
-        if (size_ - position_ - 1 >= n) {
-            return BufferIterator(ptr_ + n, data_base_, data_begin_, size_);
-        }
-
-        n -= size_ - position_;
-
-        return BufferIterator(data_base_ + n, data_base_, data_begin_, size_);
+    BufferIterator operator+(difference_type n) const {
+        return BufferIterator(buffer_, index_ + n);
     }
 
-    BufferIterator operator-(size_type n) const {
-        n %= size_;
-
-        return (*this + (size_ - n));
+    BufferIterator operator-(difference_type n) const {
+        return BufferIterator(buffer_, index_ - n);
     }
 
-    int64_t operator-(const BufferIterator& rhs) const {
-        int64_t distance = ptr_ - rhs.ptr_;
-
-        if (
-        (data_begin_ <= ptr_ && data_begin_ <= rhs.ptr_) ||
-        (data_begin_ > ptr_ && data_begin_ > rhs.ptr_)
-        ) {
-            return distance;
-        }
-
-        int64_t abstract_distance = std::max(ptr_, rhs.ptr_) - std::min(ptr_, rhs.ptr_);
-        int sign = (ptr_ < rhs.ptr_ ? 1 : -1);
-
-        return sign * (size_ - abstract_distance);
+    difference_type operator-(const BufferIterator& rhs) const {
+        return index_ - rhs.index_;
     }
 
-    friend BufferIterator& operator+(size_type lhs, const BufferIterator& rhs) {
+    friend BufferIterator operator+(difference_type lhs, const BufferIterator& rhs) {
         return rhs + lhs;
     }
 public:
     bool operator==(const BufferIterator& other) const {
-        return ptr_ == other.ptr_;
+        return index_ == other.index_;
     }
 
     bool operator!=(const BufferIterator& other) const {
@@ -136,78 +182,109 @@ public:
     }
 
     bool operator>(const BufferIterator& other) const {
-        return (*this - other) > 0;
+        return index_ > other.index_;
     }
 
     bool operator<(const BufferIterator& other) const {
-        return (*this - other) < 0;
+        return index_ < other.index_;
     }
 
     bool operator>=(const BufferIterator& other) const {
-        return (*this - other) >= 0;
+        return index_ >= other.index_;
     }
 
     bool operator<=(const BufferIterator& other) const {
-        return (*this - other) <= 0;
+        return index_ <= other.index_;
     }
 private:
-    pointer ptr_;
-    pointer data_base_;
-    pointer data_begin_;
-    size_type size_;
-    size_type position_;
+    template<typename>
+    friend class BufferIterator;
+
+    Buffer* buffer_;
+    difference_type index_;
+};
+
+// A stretch of the ring split at the wrap point: `first` comes first in ring
+// order and `second` is the part that wrapped to the start of the storage,
+// empty if nothing wrapped.
+template<typename T>
+struct RingSpans {
+    std::span<T> first;
+    std::span<T> second;
+
+    std::size_t size() const {
+        return first.size() + second.size();
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
 };
 
 template<
     typename T,
-    typename Allocator = std::allocator<T>
+    typename Allocator = std::allocator<T>,
+    typename Indexing = ModuloIndexing,
+    typename Stats = NoStats,
+    typename Storage = HeapStorage
 >
 class CircularBuffer {
 public:
-    using value_type       = typename Allocator::value_type;
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
     using reference        = value_type&;
     using const_reference  = const value_type&;
-    using iterator         = BufferIterator<CircularBuffer<T>>;
-    using const_iterator   = BufferIterator<const CircularBuffer<T>>;
-    using difference_type  = typename Allocator::difference_type;
-    using size_type        = typename Allocator::size_type;
+    using iterator         = BufferIterator<CircularBuffer<T, Allocator, Indexing, Stats, Storage>>;
+    using const_iterator   = BufferIterator<const CircularBuffer<T, Allocator, Indexing, Stats, Storage>>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type   = Allocator;
 public:
     CircularBuffer()
-        : capacity_(0)
-        , real_capacity_(1)
+        : CircularBuffer(Allocator())
+    {}
+
+    // With inline storage the buffer starts at the inline capacity and
+    // does not allocate.
+    explicit CircularBuffer(const Allocator& alloc)
+        : capacity_(kInlineCapacity)
+        , real_capacity_(Indexing::Slots(kInlineCapacity))
         , size_(0)
+        , alloc_(alloc)
         , begin_pos_(0)
         , end_pos_(0)
     {
-        data_ = alloc_.allocate(real_capacity_);
-        alloc_.construct(data_, value_type{});
+        data_ = AllocateSlots(real_capacity_);
     }
 
-    CircularBuffer(size_type size)
-        : capacity_(size)
-        , real_capacity_(size + 1)
+    CircularBuffer(size_type size, const Allocator& alloc = Allocator())
+        : capacity_(Indexing::Capacity(size))
+        , real_capacity_(Indexing::Slots(capacity_))
         , size_(size)
+        , alloc_(alloc)
         , begin_pos_(0)
         , end_pos_(size)
     {
-        data_ = alloc_.allocate(real_capacity_);
+        data_ = AllocateSlots(real_capacity_);
 
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, value_type{});
+        for (size_type i = 0; i < size_; ++i) {
+            AllocTraits::construct(alloc_, data_ + i);
         }
     }
 
-    CircularBuffer(size_type size, const_reference fill_with)
-        : capacity_(size)
-        , real_capacity_(size + 1)
+    CircularBuffer(size_type size, const_reference fill_with, const Allocator& alloc = Allocator())
+        : capacity_(Indexing::Capacity(size))
+        , real_capacity_(Indexing::Slots(capacity_))
         , size_(size)
+        , alloc_(alloc)
         , begin_pos_(0)
         , end_pos_(size)
     {
-        data_ = alloc_.allocate(real_capacity_);
+        data_ = AllocateSlots(real_capacity_);
 
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, fill_with);
+        for (size_type i = 0; i < size_; ++i) {
+            AllocTraits::construct(alloc_, data_ + i, fill_with);
         }
     }
 
@@ -215,7 +292,9 @@ public:
         typename InputIterator,
         typename = std::_RequireInputIter<InputIterator>
     >
-    CircularBuffer(InputIterator first, InputIterator last) {
+    CircularBuffer(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+    {
         InputIterator temp_first = first;
         size_ = 0;
 
@@ -224,178 +303,223 @@ public:
             ++temp_first;
         }
 
-        capacity_ = size_;
-        real_capacity_ = size_ + 1;
+        capacity_ = Indexing::Capacity(size_);
+        real_capacity_ = Indexing::Slots(capacity_);
         begin_pos_ = 0;
         end_pos_ = size_;
-        data_ = alloc_.allocate(real_capacity_);
+        data_ = AllocateSlots(real_capacity_);
 
         size_type current_index = 0;
 
         while (first != last) {
-            alloc_.construct(data_ + current_index, *first);
+            AllocTraits::construct(alloc_, data_ + current_index, *first);
             ++first;
             ++current_index;
         }
-
-        for (; current_index < real_capacity_; ++current_index) {
-            alloc_.construct(data_ + current_index, *(first - 1));
-        }
     }
 
-    CircularBuffer(const std::initializer_list<value_type>& init_list)
-        : capacity_(init_list.end() - init_list.begin())
-        , real_capacity_(init_list.end() - init_list.begin() + 1)
-        , size_(init_list.end() - init_list.begin())
-        , begin_pos_(0)
-        , end_pos_(init_list.end() - init_list.begin())
-    {
-        data_ = alloc_.allocate(real_capacity_);
-        
-        auto current = init_list.begin();
+    CircularBuffer(const std::initializer_list<value_type>& init_list, const Allocator& alloc = Allocator())
+        : CircularBuffer(init_list.begin(), init_list.end(), alloc)
+    {}
 
-        for (size_type i = 0; i < size_; ++i) {
-            alloc_.construct(data_ + i, *current);
-            ++current;
-        }
+    CircularBuffer(const CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other)
+        : CircularBuffer(other, AllocTraits::select_on_container_copy_construction(other.alloc_))
+    {}
 
-        for (size_type i = size_; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, *(current - 1));
-        }
+    CircularBuffer(const CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other, const Allocator& alloc)
+        : capacity_(other.capacity_)
+        , real_capacity_(Indexing::Slots(other.capacity_))
+        , size_(other.size_)
+        , alloc_(alloc)
+        , begin_pos_(0)
+        , end_pos_(other.size_)
+        , stats_(other.stats_)
+    {
+        data_ = AllocateSlots(real_capacity_);
+        CopyElementsFrom(other);
     }
 
-    CircularBuffer(const CircularBuffer<value_type, Allocator>& other)
+    // Inline slots stay with their buffer, so moving an inline buffer moves
+    // its elements one by one.
+    CircularBuffer(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>&& other) noexcept(kNothrowMove)
         : capacity_(other.capacity_)
         , real_capacity_(other.real_capacity_)
         , size_(other.size_)
+        , data_(other.data_)
+        , alloc_(std::move(other.alloc_))
         , begin_pos_(other.begin_pos_)
         , end_pos_(other.end_pos_)
+        , stats_(std::move(other.stats_))
     {
-        data_ = alloc_.allocate(real_capacity_);
-        
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, other.data_[i]);
+        TakeStorageOf(other);
+    }
+
+    // Steals the storage when `alloc` can free it, moves element by element
+    // otherwise.
+    CircularBuffer(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>&& other, const Allocator& alloc)
+        : capacity_(0)
+        , real_capacity_(Indexing::Slots(0))
+        , size_(0)
+        , data_(nullptr)
+        , alloc_(alloc)
+        , begin_pos_(0)
+        , end_pos_(0)
+        , stats_(std::move(other.stats_))
+    {
+        if (alloc_ == other.alloc_) {
+            StealFrom(other);
+        } else {
+            MoveElementsFrom(other);
         }
     }
 
-    CircularBuffer& operator=(const CircularBuffer<value_type, Allocator>& other) {
+    CircularBuffer& operator=(const CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other) {
         if (this == &other) {
             return *this;
         }
 
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.destroy(data_ + i);
+        // Storage that already fits other's capacity is kept, so assigning
+        // between equally sized buffers never allocates. A propagated
+        // allocator that differs from ours cannot free our block, though.
+        bool reuse = data_ != nullptr && Indexing::Slots(other.capacity_) <= real_capacity_;
+
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+            reuse = reuse && alloc_ == other.alloc_;
         }
 
-        alloc_.deallocate(data_, real_capacity_);
+        if (reuse) {
+            DropFront(size_);
+        } else {
+            DestroyStorage();
+            LeaveEmpty();
+
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                alloc_ = other.alloc_;
+            }
+
+            data_ = AllocateSlots(Indexing::Slots(other.capacity_));
+            real_capacity_ = Indexing::Slots(other.capacity_);
+        }
 
         capacity_ = other.capacity_;
-        real_capacity_ = other.real_capacity_;
         size_ = other.size_;
-        data_ = alloc_.allocate(real_capacity_);
-        begin_pos_ = other.begin_pos_;
-        end_pos_ = other.end_pos_;
+        begin_pos_ = 0;
+        end_pos_ = size_;
+        stats_ = other.stats_;
+
+        CopyElementsFrom(other);
+
+        return *this;
+    }
+
+    // With an allocator that neither propagates nor always compares equal,
+    // unequal allocators force an element-wise move into our own storage.
+    CircularBuffer& operator=(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>&& other) noexcept(
+        (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) &&
+        kNothrowMove
+    ) {
+        if (this == &other) {
+            return *this;
+        }
+
+        DestroyStorage();
+        LeaveEmpty();
 
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, other.data_[i]);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+            StealFrom(other);
+        } else if (alloc_ == other.alloc_) {
+            StealFrom(other);
+        } else {
+            MoveElementsFrom(other);
         }
 
+        stats_ = std::move(other.stats_);
+
         return *this;
     }
 
     CircularBuffer& operator=(const std::initializer_list<value_type>& other) {
-        alloc_.deallocate(data_, real_capacity_);
-
-        capacity_ = other.end() - other.begin();
-        real_capacity_ = capacity_ + 1;
-        size_ = capacity_;
-        data_ = alloc_.allocate(real_capacity_);
-        begin_pos_ = 0;
-        end_pos_ = size_;
+        DestroyStorage();
+        LeaveEmpty();
 
-        auto current = other.begin();
+        data_ = AllocateSlots(Indexing::Slots(Indexing::Capacity(other.size())));
+        capacity_ = Indexing::Capacity(other.size());
+        real_capacity_ = Indexing::Slots(capacity_);
 
-        for (size_type i = 0; i < size_; ++i) {
-            alloc_.construct(data_ + i, *current);
-            ++current;
+        for (const value_type& value : other) {
+            AllocTraits::construct(alloc_, data_ + size_, value);
+            ++size_;
         }
 
-        for (size_type i = size_; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, *(current - 1));
-        }
+        end_pos_ = size_;
 
         return *this;
     }
 
     ~CircularBuffer() {
-        for (size_t i = 0; i < real_capacity_; ++i) {
-            alloc_.destroy(data_ + i);
-        }
-
-        alloc_.deallocate(data_, real_capacity_);
+        DestroyStorage();
     }
 public:
     iterator begin() {
-        return iterator(
-            data_ + begin_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return iterator(this, 0);
     }
 
     iterator end() {
-        return iterator(
-            data_ + end_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return iterator(this, size_);
     }
 
     const_iterator begin() const {
-        return const_iterator(
-            data_ + begin_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return const_iterator(this, 0);
     }
 
     const_iterator end() const {
-        return const_iterator(
-            data_ + end_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return const_iterator(this, size_);
     }
 
     const_iterator cbegin() const {
-        return const_iterator(
-            data_ + begin_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return const_iterator(this, 0);
     }
 
     const_iterator cend() const {
-        return const_iterator(
-            data_ + end_pos_,
-            data_,
-            data_ + begin_pos_,
-            real_capacity_
-        );
+        return const_iterator(this, size_);
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const {
+        return rend();
     }
 
     template<typename Container>
     bool operator==(const Container& other) const {
-        return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+        if constexpr (cb::SegmentedBuffer<const Container>) {
+            return cb::equal(*this, other);
+        } else {
+            return size_ == other.size() && cb::equal(*this, other.begin());
+        }
     }
 
     bool operator==(const std::initializer_list<value_type>& other) const {
-        return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+        return size_ == other.size() && cb::equal(*this, other.begin());
     }
 
     template<typename Container>
@@ -407,14 +531,53 @@ public:
         return !(*this == other);
     }
 
-    void swap(CircularBuffer& other) {
-        std::swap(*this, other);
+    // Swapping buffers with unequal, non-propagating allocators is undefined,
+    // as for the standard containers.
+    void swap(CircularBuffer& other) noexcept(kNothrowMove) {
+        // Inline slots cannot be exchanged, so the contents go through a
+        // temporary instead.
+        if constexpr (InlineSlots::kCount != 0) {
+            if (IsInline() || other.IsInline()) {
+                CircularBuffer temp(std::move(other));
+
+                other = std::move(*this);
+                *this = std::move(temp);
+
+                return;
+            }
+        }
+
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+
+        std::swap(capacity_, other.capacity_);
+        std::swap(real_capacity_, other.real_capacity_);
+        std::swap(size_, other.size_);
+        std::swap(data_, other.data_);
+        std::swap(begin_pos_, other.begin_pos_);
+        std::swap(end_pos_, other.end_pos_);
+        std::swap(stats_, other.stats_);
     }
 
-    friend void swap(CircularBuffer& lhs, CircularBuffer& rhs) {
+    friend void swap(CircularBuffer& lhs, CircularBuffer& rhs) noexcept(noexcept(lhs.swap(rhs))) {
         lhs.swap(rhs);
     }
 
+    allocator_type get_allocator() const {
+        return alloc_;
+    }
+
+    // The statistics policy; it is copied, moved and swapped along with the
+    // contents.
+    const Stats& stats() const {
+        return stats_;
+    }
+
+    Stats& stats() {
+        return stats_;
+    }
+
     size_type size() const {
         return size_;
     }
@@ -468,35 +631,30 @@ public:
     }
 public:
     iterator insert(iterator p, const_reference t) {
-        for (auto it = end() - 1; it != (p - 1); --it) {
-            *(it + 1) = *it;
-        }
+        return emplace(p, t);
+    }
 
-        *p = t;
-        
-        if (size_ < capacity_) {
-            ++size_;
-            end_pos_ = GetNextPosition(end_pos_);
-        }
+    iterator insert(iterator p, value_type&& t) {
+        return emplace(p, std::move(t));
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator p, Args&&... args) {
+        size_type index = p - begin();
+        value_type value(std::forward<Args>(args)...);
+
+        InsertAt(index, 1, [&value]() -> value_type&& { return std::move(value); });
 
-        return p;
+        return begin() + index;
     }
 
     iterator insert(iterator p, size_type n, const_reference t) {
-        for (auto it = end() - 1; it != (p + n - 2); --it) {
-            *(it + 1) = *it;
-        }
-
-        for (size_type i = 0; i < n; ++i) {
-            *(p + i) = t;
-        }
+        size_type index = p - begin();
+        value_type value(t);
 
-        if (size_ + n <= capacity_) {
-            size_ += n;
-            end_pos_ = (end_pos_ + n) % real_capacity_;
-        }
+        InsertAt(index, n, [&value]() -> const_reference { return value; });
 
-        return p;
+        return begin() + index;
     }
     
     template<
@@ -504,29 +662,17 @@ public:
         typename = std::_RequireInputIter<InputIterator>
     >
     iterator insert(iterator p, InputIterator first, InputIterator last) {
-        InputIterator temp_first = first;
-        size_type n = 0;
-
-        while (temp_first != last) {
-            ++n;
-            ++temp_first;
-        }
-
-        for (auto it = end() - 1; it != (p + n - 2); --it) {
-            *(it + 1) = *it;
-        }
+        size_type index = p - begin();
+        size_type n = std::distance(first, last);
 
-        for (size_type i = 0; i < n; ++i) {
-            *(p + i) = *first;
+        InsertAt(index, n, [&first]() -> typename std::iterator_traits<InputIterator>::reference {
+            InputIterator current = first;
             ++first;
-        }
 
-        if (size_ + n <= capacity_) {
-            size_ += n;
-            end_pos_ = (end_pos_ + n) % real_capacity_;
-        }
+            return *current;
+        });
 
-        return p;
+        return begin() + index;
     }
 
     iterator insert(iterator p, const std::initializer_list<value_type>& init_list) {
@@ -538,37 +684,29 @@ public:
             throw std::runtime_error("Cannot erase non-existing element");
         }
 
-        for (auto it = q; it != end(); ++it) {
-            *it = *(it + 1);
-        }
-
-        --size_;
-        end_pos_ = GetPrevPosition(end_pos_);
+        size_type index = q - begin();
+        EraseAt(index, 1);
 
-        return q;
+        return begin() + index;
     }
 
     iterator erase(iterator q1, iterator q2) {
         size_type removed = q2 - q1;
 
-        if (empty() || size_ < removed || q1 >= end() || q2 >= end()) {
+        if (empty() || size_ < removed || q1 >= end() || q2 > end()) {
             throw std::runtime_error("Cannot erase non-existing element");
         }
 
-        for (auto it = q1; it + removed != end(); ++it) {
-            *it = *(it + removed);
-        }
-
-        size_ -= removed;
-        end_pos_ = ((end_pos_ - removed) % real_capacity_ + real_capacity_) % real_capacity_;
+        size_type index = q1 - begin();
+        EraseAt(index, removed);
 
-        return q1;
+        return begin() + index;
     }
 
     void clear() {
-        while (!empty()) {
-            pop_front();
-        }
+        DropFront(size_);
+        begin_pos_ = 0;
+        end_pos_ = 0;
     }
 
     void reserve(size_type n) {
@@ -576,62 +714,27 @@ public:
             return;
         }
 
-        value_type* ndata = alloc_.allocate(n + 1);
-
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(ndata + i, data_[i]);
-        }
-
-        alloc_.deallocate(data_, real_capacity_);
-
-        capacity_ = n;
-        real_capacity_ = n + 1;
-        data_ = ndata;
+        Reallocate(n);
     }
 
     void resize(size_type n) {
-        if (n <= size_) {
-            auto to_move = size_ - n;
-            
-            size_ = n;
-            end_pos_ = ((end_pos_ - to_move) % real_capacity_ + real_capacity_) % real_capacity_;
-
-            return;
+        while (size_ > n) {
+            pop_back();
         }
 
         reserve(n);
-        auto it = end();
 
         while (size_ < n) {
-            *it = value_type{};
-            ++it;
-            ++size_;
-            end_pos_ = GetNextPosition(end_pos_); 
+            emplace_back();
         }
     }
 
     void assign(size_type n, const_reference t) {
-        if (size_ <= n) {
-            resize(n);
-        } else {
-            for (size_type i = 0; i < real_capacity_; ++i) {
-                alloc_.destroy(data_ + i);
-            }
-
-            alloc_.deallocate(data_, real_capacity_);
-
-            value_type* ndata = alloc_.allocate(n);
-
-            begin_pos_ = 0;
-            end_pos_ = n;
-            size_ = n;
-            capacity_ = n;
-            real_capacity_ = n + 1;
-            data_ = ndata;
-        }
+        clear();
+        reserve(n);
 
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, t);
+        for (size_type i = 0; i < n; ++i) {
+            emplace_back(t);
         }
     }
 
@@ -640,35 +743,11 @@ public:
         typename = std::_RequireInputIter<InputIterator>
     >
     void assign(InputIterator first, InputIterator last) {
-        InputIterator temp_first = first;
-        size_type n = 0;
-
-        while (temp_first != last) {
-            ++n;
-            ++temp_first;
-        }
-
-        if (size_ <= n) {
-            reserve(n);
-        } else {
-            for (size_type i = 0; i < real_capacity_; ++i) {
-                alloc_.destroy(data_ + i);
-            }
-
-            alloc_.deallocate(data_, real_capacity_);
-
-            value_type* ndata = alloc_.allocate(n);
+        clear();
+        reserve(std::distance(first, last));
 
-            begin_pos_ = 0;
-            end_pos_ = n;
-            size_ = n;
-            capacity_ = n;
-            real_capacity_ = n + 1;
-            data_ = ndata;
-        }
-
-        for (size_type i = 0; i < real_capacity_; ++i) {
-            alloc_.construct(data_ + i, *first);
+        while (first != last) {
+            emplace_back(*first);
             ++first;
         }
     }
@@ -678,35 +757,79 @@ public:
     }
 public:
     virtual void push_front(const_reference element) {
-        begin_pos_ = GetPrevPosition(begin_pos_);
+        emplace_front(element);
+    }
+
+    virtual void push_front(value_type&& element) {
+        emplace_front(std::move(element));
+    }
+
+    virtual void push_back(const_reference element) {
+        emplace_back(element);
+    }
+
+    virtual void push_back(value_type&& element) {
+        emplace_back(std::move(element));
+    }
+
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        if (capacity_ == 0) {
+            return;
+        }
 
         if (size_ < capacity_) {
-            data_[begin_pos_] = element;
+            AllocTraits::construct(alloc_, data_ + GetSlot(GetPrevPosition(begin_pos_)), std::forward<Args>(args)...);
+            begin_pos_ = GetPrevPosition(begin_pos_);
             ++size_;
+        } else if constexpr (Indexing::kHasSpareSlot) {
+            AllocTraits::construct(alloc_, data_ + GetSlot(GetPrevPosition(begin_pos_)), std::forward<Args>(args)...);
+            begin_pos_ = GetPrevPosition(begin_pos_);
+            end_pos_ = GetPrevPosition(end_pos_);
+            stats_.OnOverwrite(data_[GetSlot(end_pos_)]);
+            AllocTraits::destroy(alloc_, data_ + GetSlot(end_pos_));
+        } else {
+            // Without a spare slot the new front shares its slot with the
+            // current back, so the value has to be built before eviction.
+            value_type value(std::forward<Args>(args)...);
 
-            return;
+            end_pos_ = GetPrevPosition(end_pos_);
+            stats_.OnOverwrite(data_[GetSlot(end_pos_)]);
+            AllocTraits::destroy(alloc_, data_ + GetSlot(end_pos_));
+            AllocTraits::construct(alloc_, data_ + GetSlot(GetPrevPosition(begin_pos_)), std::move(value));
+            begin_pos_ = GetPrevPosition(begin_pos_);
         }
 
-        std::swap(data_[end_pos_], data_[GetPrevPosition(end_pos_)]);
-        
-        data_[begin_pos_] = element;
-        end_pos_ = GetPrevPosition(end_pos_);
+        stats_.OnPush(1, size_);
     }
 
-    virtual void push_back(const_reference element) {
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (capacity_ == 0) {
+            return;
+        }
+
         if (size_ < capacity_) {
-            data_[size_] = element;
+            AllocTraits::construct(alloc_, data_ + GetSlot(end_pos_), std::forward<Args>(args)...);
             end_pos_ = GetNextPosition(end_pos_);
             ++size_;
+        } else if constexpr (Indexing::kHasSpareSlot) {
+            AllocTraits::construct(alloc_, data_ + GetSlot(end_pos_), std::forward<Args>(args)...);
+            end_pos_ = GetNextPosition(end_pos_);
+            stats_.OnOverwrite(data_[GetSlot(begin_pos_)]);
+            AllocTraits::destroy(alloc_, data_ + GetSlot(begin_pos_));
+            begin_pos_ = GetNextPosition(begin_pos_);
+        } else {
+            value_type value(std::forward<Args>(args)...);
 
-            return;
+            stats_.OnOverwrite(data_[GetSlot(begin_pos_)]);
+            AllocTraits::destroy(alloc_, data_ + GetSlot(begin_pos_));
+            begin_pos_ = GetNextPosition(begin_pos_);
+            AllocTraits::construct(alloc_, data_ + GetSlot(end_pos_), std::move(value));
+            end_pos_ = GetNextPosition(end_pos_);
         }
 
-        std::swap(data_[begin_pos_], data_[end_pos_]);
-
-        data_[end_pos_] = element;
-        begin_pos_ = GetNextPosition(begin_pos_);
-        end_pos_ = GetNextPosition(end_pos_);
+        stats_.OnPush(1, size_);
     }
 
     void pop_front() {
@@ -714,8 +837,10 @@ public:
             throw std::runtime_error("Cannot delete the element from empty buffer.");
         }
 
+        AllocTraits::destroy(alloc_, data_ + GetSlot(begin_pos_));
         --size_;
         begin_pos_ = GetNextPosition(begin_pos_);
+        stats_.OnPop(1);
     }
 
     void pop_back() {
@@ -725,22 +850,117 @@ public:
 
         --size_;
         end_pos_ = GetPrevPosition(end_pos_);
+        AllocTraits::destroy(alloc_, data_ + GetSlot(end_pos_));
+        stats_.OnPop(1);
     }
 public:
-    reference operator[](size_type n) {
-        return *(begin() + n);
+    // Bulk operations split the work at the wrap point into at most two runs
+    // and copy trivially copyable elements with memcpy. Like push_back, the
+    // oldest elements are overwritten once the capacity is exceeded.
+    virtual void push_back_n(const value_type* items, size_type n) {
+        AppendN(items, n);
     }
 
-    const_reference operator[](size_type n) const {
-        return *(begin() + n);
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    void append(InputIterator first, InputIterator last) {
+        if constexpr (std::forward_iterator<InputIterator>) {
+            AppendN(first, std::distance(first, last));
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
     }
 
-    reference at(size_type n) {
-        if (n >= size()) {
-            throw std::out_of_range("The index of element exceeds the size of buffer.");
-        }
+    // Moves up to `n` elements from the front into `out` and returns how
+    // many were popped.
+    size_type pop_front_n(value_type* out, size_type n) {
+        n = std::min(n, size_);
+
+        size_type slot = GetSlot(begin_pos_);
+        size_type first_run = std::min(n, real_capacity_ - slot);
+
+        MoveOutRun(data_ + slot, first_run, out);
+        MoveOutRun(data_, n - first_run, out + first_run);
+
+        begin_pos_ = Indexing::Advance(begin_pos_, n, real_capacity_);
+        size_ -= n;
+        stats_.OnPop(n);
 
-        return *(begin() + n);
+        return n;
+    }
+
+    // Zero-copy writes: prepare(n) hands out up to `n` free slots after
+    // back() (fewer if the buffer lacks room; it never overwrites), the
+    // caller fills a prefix of them in place and commit(k) appends those
+    // `k` elements. The slots are raw storage, hence the type restriction.
+    RingSpans<value_type> prepare(size_type n) {
+        static_assert(std::is_trivially_copyable_v<value_type>, "prepare() requires a trivially copyable type.");
+
+        n = std::min(n, capacity_ - size_);
+
+        size_type slot = GetSlot(end_pos_);
+        size_type first_run = std::min(n, real_capacity_ - slot);
+
+        return {std::span<value_type>(data_ + slot, first_run), std::span<value_type>(data_, n - first_run)};
+    }
+
+    void commit(size_type k) {
+        static_assert(std::is_trivially_copyable_v<value_type>, "commit() requires a trivially copyable type.");
+
+        if (k > capacity_ - size_) {
+            throw std::invalid_argument("Cannot commit more slots than are free.");
+        }
+
+        end_pos_ = Indexing::Advance(end_pos_, k, real_capacity_);
+        size_ += k;
+        stats_.OnPush(k, size_);
+    }
+
+    // Zero-copy reads: peek(n) exposes up to `n` elements from the front in
+    // place and consume(k) pops the first `k` of them.
+    RingSpans<value_type> peek(size_type n) {
+        n = std::min(n, size_);
+
+        size_type first_run = std::min(n, GetFirstSegmentSize());
+
+        return {array_one().first(first_run), array_two().first(n - first_run)};
+    }
+
+    RingSpans<const value_type> peek(size_type n) const {
+        n = std::min(n, size_);
+
+        size_type first_run = std::min(n, GetFirstSegmentSize());
+
+        return {array_one().first(first_run), array_two().first(n - first_run)};
+    }
+
+    void consume(size_type k) {
+        if (k > size_) {
+            throw std::invalid_argument("Cannot consume more elements than are readable.");
+        }
+
+        DropFront(k);
+        stats_.OnPop(k);
+    }
+public:
+    reference operator[](size_type n) {
+        return data_[GetSlot(GetPosition(n))];
+    }
+
+    const_reference operator[](size_type n) const {
+        return data_[GetSlot(GetPosition(n))];
+    }
+
+    reference at(size_type n) {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return (*this)[n];
     }
 
     const_reference at(size_type n) const {
@@ -748,10 +968,77 @@ public:
             throw std::out_of_range("The index of element exceeds the size of buffer.");
         }
 
-        return *(begin() + n);
+        return (*this)[n];
+    }
+public:
+    // The live elements occupy at most two contiguous runs of storage:
+    // array_one() starts at front(), array_two() holds whatever wrapped
+    // around to the beginning of the storage and is empty otherwise.
+    std::span<value_type> array_one() {
+        return std::span<value_type>(data_ + GetSlot(begin_pos_), GetFirstSegmentSize());
+    }
+
+    std::span<value_type> array_two() {
+        return std::span<value_type>(data_, size_ - GetFirstSegmentSize());
+    }
+
+    std::span<const value_type> array_one() const {
+        return std::span<const value_type>(data_ + GetSlot(begin_pos_), GetFirstSegmentSize());
+    }
+
+    std::span<const value_type> array_two() const {
+        return std::span<const value_type>(data_, size_ - GetFirstSegmentSize());
+    }
+
+    bool is_linearized() const {
+        return GetFirstSegmentSize() == size_;
+    }
+
+    // Rotates the storage in place so that all elements form one contiguous
+    // run starting at the first slot. Iterators stay valid, references do not.
+    std::span<value_type> linearize() {
+        if (is_linearized()) {
+            return array_one();
+        }
+
+        size_type first_size = GetFirstSegmentSize();
+        size_type second_size = size_ - first_size;
+        size_type first_slot = GetSlot(begin_pos_);
+
+        // Slide the first run down so it follows the wrapped one directly:
+        // slots in the free gap are constructed, live ones are assigned.
+        for (size_type i = 0; i < first_size && second_size != first_slot; ++i) {
+            value_type* from = data_ + first_slot + i;
+            value_type* to = data_ + second_size + i;
+
+            if (second_size + i < first_slot) {
+                AllocTraits::construct(alloc_, to, std::move(*from));
+            } else {
+                *to = std::move(*from);
+            }
+        }
+
+        for (size_type slot = std::max(first_slot, size_); slot < first_slot + first_size; ++slot) {
+            AllocTraits::destroy(alloc_, data_ + slot);
+        }
+
+        std::rotate(data_, data_ + second_size, data_ + size_);
+
+        begin_pos_ = 0;
+        end_pos_ = size_;
+
+        return array_one();
     }
+protected:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using InlineSlots = typename Storage::template Slots<value_type, Indexing>;
+
+    static constexpr size_type kInlineCapacity = Indexing::Capacity(Storage::kInlineCapacity);
+    static constexpr bool kNothrowMove = InlineSlots::kCount == 0 || std::is_nothrow_move_constructible_v<value_type>;
 protected:
     size_type capacity_;
+    // Slots actually allocated: Indexing::Slots(capacity_), or more after a
+    // copy assignment reused a larger block.
     size_type real_capacity_;
     size_type size_;
     value_type* data_;
@@ -759,279 +1046,1357 @@ protected:
 protected:
     size_type begin_pos_;
     size_type end_pos_;
+    [[no_unique_address]] Stats stats_;
+    [[no_unique_address]] InlineSlots inline_;
 protected:
-    size_type GetPrevPosition(size_type pos) {
-        return pos <= 0 ? pos + real_capacity_ - 1 : pos - 1;
+    // Only the slots in [begin_pos_, end_pos_) hold constructed objects,
+    // the rest of the storage (including the spare slot) is raw memory.
+    void CopyElementsFrom(const CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            size_type first_run = other.GetFirstSegmentSize();
+
+            if (first_run != 0) {
+                std::memcpy(data_, other.data_ + other.GetSlot(other.begin_pos_), first_run * sizeof(value_type));
+            }
+
+            if (other.size_ != first_run) {
+                std::memcpy(data_ + first_run, other.data_, (other.size_ - first_run) * sizeof(value_type));
+            }
+
+            return;
+        }
+
+        size_type current_index = 0;
+
+        for (size_type pos = other.begin_pos_; pos != other.end_pos_; pos = other.GetNextPosition(pos)) {
+            AllocTraits::construct(alloc_, data_ + current_index, other.data_[other.GetSlot(pos)]);
+            ++current_index;
+        }
     }
 
-    size_type GetNextPosition(size_type pos) {
-        return pos + 1 >= real_capacity_ ? pos + 1 - real_capacity_ : pos + 1;
+    // Takes over the storage of `other`, which must use an equal allocator.
+    void StealFrom(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other) {
+        capacity_ = other.capacity_;
+        real_capacity_ = other.real_capacity_;
+        size_ = other.size_;
+        data_ = other.data_;
+        begin_pos_ = other.begin_pos_;
+        end_pos_ = other.end_pos_;
+
+        TakeStorageOf(other);
     }
-};
 
-template<
-    typename T,
-    typename Allocator = std::allocator<T>
->
-class CircularBufferExt : public CircularBuffer<T> {
-public:
-    using value_type       = typename Allocator::value_type;
-    using reference        = value_type&;
-    using const_reference  = const value_type&;
-    using iterator         = BufferIterator<CircularBufferExt<T>>;
-    using const_iterator   = BufferIterator<const CircularBufferExt<T>>;
-    using difference_type  = typename Allocator::difference_type;
-    using size_type        = typename Allocator::size_type;
-public:
-    CircularBufferExt()
-        : CircularBuffer<T>()
-    {}
+    // Called once the fields of `other` have been copied. A heap block
+    // simply changes hands; inline elements are moved into our own inline
+    // slots at the same positions and `other` is cleared.
+    void TakeStorageOf(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other) {
+        if constexpr (InlineSlots::kCount != 0) {
+            if (other.IsInline()) {
+                data_ = inline_.data();
 
-    CircularBufferExt(size_type capacity)
-        : CircularBuffer<T>(capacity)
-    {}
+                for (size_type pos = begin_pos_; pos != end_pos_; pos = GetNextPosition(pos)) {
+                    AllocTraits::construct(alloc_, data_ + GetSlot(pos), std::move(other.data_[GetSlot(pos)]));
+                }
 
-    CircularBufferExt(size_type size, const_reference fill_with)
-        : CircularBuffer<T>(size, fill_with)
-    {}
+                other.clear();
 
-    template<
-        typename InputIterator,
-        typename = std::_RequireInputIter<InputIterator>
-    >
-    CircularBufferExt(InputIterator first, InputIterator last) 
-        : CircularBuffer<T>(first, last)
-    {}
+                return;
+            }
+        }
 
-    CircularBufferExt(const std::initializer_list<value_type>& init_list)
-        : CircularBuffer<T>(init_list)
-    {}
+        other.LeaveEmpty();
+    }
 
-    CircularBufferExt(const CircularBufferExt<value_type, Allocator>& other)
-        : CircularBuffer<T>(other)
-    {}
+    // Moves the elements of `other` into fresh storage from our allocator;
+    // `other` keeps its (now moved-from) elements.
+    void MoveElementsFrom(CircularBuffer<value_type, Allocator, Indexing, Stats, Storage>& other) {
+        data_ = AllocateSlots(other.real_capacity_);
+        capacity_ = other.capacity_;
+        real_capacity_ = other.real_capacity_;
 
-    CircularBufferExt& operator=(const CircularBufferExt<value_type, Allocator>& other) {
-        if (this == &other) {
-            return *this;
+        for (size_type pos = other.begin_pos_; pos != other.end_pos_; pos = other.GetNextPosition(pos)) {
+            AllocTraits::construct(alloc_, data_ + size_, std::move(other.data_[other.GetSlot(pos)]));
+            ++size_;
+        }
+
+        end_pos_ = size_;
+    }
+
+    void DestroyStorage() {
+        if (data_ == nullptr) {
+            return;
         }
 
-        for (size_t i = 0; i < this->real_capacity_; ++i) {
-            this->alloc_.destroy(this->data_ + i);
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type pos = begin_pos_; pos != end_pos_; pos = GetNextPosition(pos)) {
+                AllocTraits::destroy(alloc_, data_ + GetSlot(pos));
+            }
         }
 
-        this->alloc_.deallocate(this->data_, this->real_capacity_);
+        DeallocateSlots(data_, real_capacity_);
+        data_ = nullptr;
+    }
 
-        this->capacity_ = other.capacity_;
-        this->real_capacity_ = other.real_capacity_;
-        this->size_ = other.size_;
-        this->data_ = this->alloc_.allocate(this->real_capacity_);
-        this->begin_pos_ = other.begin_pos_;
-        this->end_pos_ = other.end_pos_;
+    // Slots come from the inline storage whenever they fit in it; callers
+    // only ask for them while the inline slots hold no elements.
+    value_type* AllocateSlots(size_type n) {
+        if constexpr (InlineSlots::kCount != 0) {
+            if (n <= InlineSlots::kCount) {
+                return inline_.data();
+            }
 
-        for (size_type i = 0; i < this->real_capacity_; ++i) {
-            this->data_[i] = other.data_[i];
+            if constexpr (!Storage::kSpills) {
+                throw std::invalid_argument("Capacity exceeds the fixed storage.");
+            }
         }
 
-        return *this;
+        return AllocTraits::allocate(alloc_, n);
     }
 
-    CircularBufferExt& operator=(const std::initializer_list<value_type>& other) {
-        for (size_t i = 0; i < this->real_capacity_; ++i) {
-            this->alloc_.destroy(this->data_ + i);
+    void DeallocateSlots(value_type* p, size_type n) {
+        if (!inline_.holds(p)) {
+            AllocTraits::deallocate(alloc_, p, n);
         }
+    }
 
-        this->alloc_.deallocate(this->data_, this->real_capacity_);
+    bool IsInline() const {
+        return inline_.holds(data_);
+    }
 
-        this->capacity_ = other.end() - other.begin();
-        this->real_capacity_ = this->capacity_ + 1;
-        this->size_ = this->capacity_;
-        this->data_ = this->alloc_.allocate(this->real_capacity_);
-        this->begin_pos_ = 0;
-        this->end_pos_ = this->size_;
+    // Moves a linear run down so that it starts at slot zero.
+    void SlideToFront() {
+        size_type first_slot = GetSlot(begin_pos_);
 
-        auto current = other.begin();
+        for (size_type i = 0; i < size_ && first_slot != 0; ++i) {
+            value_type* from = data_ + first_slot + i;
 
-        for (size_type i = 0; i < this->size_; ++i) {
-            this->data_[i] = *current;
-            ++current;
+            if (i < first_slot) {
+                AllocTraits::construct(alloc_, data_ + i, std::move(*from));
+            } else {
+                data_[i] = std::move(*from);
+            }
         }
 
-        return *this;
-    }
-public:
-    iterator begin() {
-        return iterator(
-            this->data_ + this->begin_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+        for (size_type slot = std::max(first_slot, size_); slot < first_slot + size_; ++slot) {
+            AllocTraits::destroy(alloc_, data_ + slot);
+        }
+
+        begin_pos_ = 0;
+        end_pos_ = size_;
     }
 
-    iterator end() {
-        return iterator(
-            this->data_ + this->end_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+    // Moves the content into a fresh block of capacity `n` (at least size())
+    // as two contiguous runs, so the new layout is linear. The old elements
+    // are destroyed only after every new one has been constructed; if a
+    // copy throws, the new block is released and the buffer is untouched.
+    void Reallocate(size_type n) {
+        size_type ncapacity = Indexing::Capacity(n);
+        size_type nreal_capacity = Indexing::Slots(ncapacity);
+
+        // Resizing within the inline slots only needs the elements to start
+        // at slot zero, positions past the old slot count mean nothing yet.
+        if (IsInline() && nreal_capacity <= InlineSlots::kCount) {
+            linearize();
+            SlideToFront();
+            capacity_ = ncapacity;
+            real_capacity_ = nreal_capacity;
+
+            return;
+        }
+
+        value_type* ndata = AllocateSlots(nreal_capacity);
+        size_type first_run = GetFirstSegmentSize();
+
+        try {
+            RelocateRun(data_ + GetSlot(begin_pos_), first_run, ndata);
+
+            try {
+                RelocateRun(data_, size_ - first_run, ndata + first_run);
+            } catch (...) {
+                DestroyRun(ndata, first_run);
+                throw;
+            }
+        } catch (...) {
+            DeallocateSlots(ndata, nreal_capacity);
+            throw;
+        }
+
+        // Sizing a zero-capacity buffer is not counted as a reallocation.
+        if (capacity_ != 0) {
+            stats_.OnReallocate(size_ * sizeof(value_type));
+        }
+
+        DestroyStorage();
+
+        capacity_ = ncapacity;
+        real_capacity_ = nreal_capacity;
+        data_ = ndata;
+        begin_pos_ = 0;
+        end_pos_ = size_;
     }
 
-    const_iterator begin() const {
-        return const_iterator(
-            this->data_ + this->begin_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+    // Constructs `n` elements at `to` from those at `from`. If a copy
+    // throws, the ones already built are destroyed again.
+    void RelocateRun(value_type* from, size_type n, value_type* to) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            if (n != 0) {
+                std::memcpy(to, from, n * sizeof(value_type));
+            }
+        } else {
+            size_type i = 0;
+
+            try {
+                for (; i < n; ++i) {
+                    AllocTraits::construct(alloc_, to + i, std::move_if_noexcept(from[i]));
+                }
+            } catch (...) {
+                DestroyRun(to, i);
+                throw;
+            }
+        }
     }
 
-    const_iterator end() const {
-        return const_iterator(
-            this->data_ + this->end_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+    void DestroyRun(value_type* p, size_type n) {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < n; ++i) {
+                AllocTraits::destroy(alloc_, p + i);
+            }
+        }
     }
 
-    const_iterator cbegin() const {
-        return const_iterator(
-            this->data_ + this->begin_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+    // A buffer with inline storage falls back to its empty inline slots.
+    void LeaveEmpty() {
+        capacity_ = 0;
+        real_capacity_ = Indexing::Slots(0);
+        size_ = 0;
+        data_ = nullptr;
+        begin_pos_ = 0;
+        end_pos_ = 0;
+
+        if constexpr (InlineSlots::kCount != 0) {
+            capacity_ = kInlineCapacity;
+            real_capacity_ = Indexing::Slots(kInlineCapacity);
+            data_ = inline_.data();
+        }
     }
 
-    const_iterator cend() const {
-        return const_iterator(
-            this->data_ + this->end_pos_,
-            this->data_,
-            this->data_ + this->begin_pos_,
-            this->real_capacity_
-        );
+    // Writes `value` into the logical slot `index`, constructing it if
+    // the slot lies past the current end and assigning otherwise.
+    template<typename U>
+    void PlaceAt(size_type index, U&& value) {
+        StoreAt(GetPosition(index), index < size_, std::forward<U>(value));
     }
-public:
-    iterator insert(iterator p, const_reference t) {
-        for (auto it = this->end() - 1; it != (p - 1); --it) {
-            *(it + 1) = *it;
+
+    template<typename U>
+    void StoreAt(size_type pos, bool constructed, U&& value) {
+        if (constructed) {
+            data_[GetSlot(pos)] = std::forward<U>(value);
+        } else {
+            AllocTraits::construct(alloc_, data_ + GetSlot(pos), std::forward<U>(value));
         }
+    }
 
-        *p = t;
-        
-        if (this->size_ == this->capacity_) {
-            this->reserve(this->capacity_ * 2);
+    // Opens a gap of `n` slots at logical `index` and fills it from `generate`,
+    // shifting whichever side of `index` is shorter, like std::deque. When
+    // the result does not fit into the capacity the back side is always
+    // shifted and whatever does not fit is dropped from the back.
+    template<typename Generator>
+    void InsertAt(size_type index, size_type n, Generator generate) {
+        if (n == 0) {
+            return;
         }
 
-        ++this->size_;
-        this->end_pos_ = this->GetNextPosition(this->end_pos_);
+        if (size_ + n <= capacity_ && index < size_ - index) {
+            // New logical slot j held an element before iff j >= n.
+            size_type new_begin = Indexing::Retreat(begin_pos_, n, real_capacity_);
 
-        return p;
-    }
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                MoveTowardFront(begin_pos_, new_begin, index);
+            } else {
+                size_type from = begin_pos_;
+                size_type to = new_begin;
 
-    iterator insert(iterator p, size_type n, const_reference t) {
-        for (auto it = this->end() - 1; it != (p + n - 2); --it) {
-            *(it + 1) = *it;
+                for (size_type j = 0; j < index; ++j) {
+                    StoreAt(to, j >= n, std::move(data_[GetSlot(from)]));
+                    from = GetNextPosition(from);
+                    to = GetNextPosition(to);
+                }
+            }
+
+            size_type pos = Indexing::Advance(new_begin, index, real_capacity_);
+
+            for (size_type j = index; j < index + n; ++j) {
+                StoreAt(pos, j >= n, generate());
+                pos = GetNextPosition(pos);
+            }
+
+            begin_pos_ = new_begin;
+            size_ += n;
+            stats_.OnPush(n, size_);
+
+            return;
         }
 
-        for (size_type i = 0; i < n; ++i) {
-            *(p + i) = t;
+        size_type new_size = std::min(size_ + n, capacity_);
+
+        // The elements pushed past the capacity are dropped unread.
+        if (size_ + n > new_size && index < size_) {
+            size_type kept = std::max(index, new_size - std::min(new_size, n));
+            ReportOverwrites(kept, size_ - kept);
         }
 
-        while (this->size_ + n > this->capacity_) {
-            this->reserve(this->capacity_ * 2);
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            if (new_size > index + n) {
+                MoveTowardBack(GetPosition(index), GetPosition(index + n), new_size - n - index);
+            }
+        } else {
+            for (size_type i = new_size; i > index + n; --i) {
+                PlaceAt(i - 1, std::move(data_[GetSlot(GetPosition(i - 1 - n))]));
+            }
         }
 
-        this->size_ += n;
-        this->end_pos_ = (this->end_pos_ + n) % this->real_capacity_;
+        for (size_type i = index; i < new_size && i < index + n; ++i) {
+            PlaceAt(i, generate());
+        }
 
-        return p;
+        stats_.OnPush(std::min(n, new_size - std::min(new_size, index)), new_size);
+        size_ = new_size;
+        end_pos_ = GetPosition(size_);
     }
-    
-    template<
-        typename InputIterator,
-        typename = std::_RequireInputIter<InputIterator>
-    >
-    iterator insert(iterator p, InputIterator first, InputIterator last) {
-        InputIterator temp_first = first;
-        size_type n = 0;
 
-        while (temp_first != last) {
-            ++n;
-            ++temp_first;
+    // Closes the gap of `n` elements at logical `index` from the shorter side.
+    void EraseAt(size_type index, size_type n) {
+        if (n == 0) {
+            return;
         }
 
-        for (auto it = this->end() - 1; it != (p + n - 2); --it) {
-            *(it + 1) = *it;
-        }
+        if (index < size_ - index - n) {
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                MoveTowardBack(begin_pos_, GetPosition(n), index);
+            } else {
+                for (size_type i = index; i > 0; --i) {
+                    data_[GetSlot(GetPosition(i - 1 + n))] = std::move(data_[GetSlot(GetPosition(i - 1))]);
+                }
+            }
 
-        for (size_type i = 0; i < n; ++i) {
-            *(p + i) = *first;
-            ++first;
+            DropFront(n);
+        } else {
+            if constexpr (std::is_trivially_copyable_v<value_type>) {
+                MoveTowardFront(GetPosition(index + n), GetPosition(index), size_ - index - n);
+            } else {
+                for (size_type i = index; i + n < size_; ++i) {
+                    data_[GetSlot(GetPosition(i))] = std::move(data_[GetSlot(GetPosition(i + n))]);
+                }
+            }
+
+            DropBack(n);
         }
+    }
+
+    // Move `n` trivially copyable elements from position `from` to position
+    // `to` with one memmove per run that is contiguous on both sides. The
+    // ranges may overlap as long as `to` lies on the named side of `from`.
+    void MoveTowardFront(size_type from, size_type to, size_type n) {
+        while (n != 0) {
+            size_type from_slot = GetSlot(from);
+            size_type to_slot = GetSlot(to);
+            size_type run = std::min({n, real_capacity_ - from_slot, real_capacity_ - to_slot});
+
+            std::memmove(data_ + to_slot, data_ + from_slot, run * sizeof(value_type));
 
-        while (this->size_ + n > this->capacity_) {
-            this->reserve(this->capacity_ * 2);
+            from = Indexing::Advance(from, run, real_capacity_);
+            to = Indexing::Advance(to, run, real_capacity_);
+            n -= run;
         }
+    }
+
+    void MoveTowardBack(size_type from, size_type to, size_type n) {
+        size_type from_end = Indexing::Advance(from, n, real_capacity_);
+        size_type to_end = Indexing::Advance(to, n, real_capacity_);
 
-        this->size_ += n;
-        this->end_pos_ = (this->end_pos_ + n) % this->real_capacity_;
+        while (n != 0) {
+            // Slots [0, x_slot) end the runs that finish at from_end and to_end.
+            size_type from_slot = GetSlot(GetPrevPosition(from_end)) + 1;
+            size_type to_slot = GetSlot(GetPrevPosition(to_end)) + 1;
+            size_type run = std::min({n, from_slot, to_slot});
 
-        return p;
+            std::memmove(data_ + to_slot - run, data_ + from_slot - run, run * sizeof(value_type));
+
+            from_end = Indexing::Retreat(from_end, run, real_capacity_);
+            to_end = Indexing::Retreat(to_end, run, real_capacity_);
+            n -= run;
+        }
     }
 
-    iterator erase(iterator q) {
-        if (this->empty() || q >= this->end()) {
-            throw std::runtime_error("Cannot erase non-existing element");
+    template<typename ForwardIterator>
+    void AppendN(ForwardIterator first, size_type n) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        size_type pushed = n;
+
+        if (size_ + n > capacity_) {
+            size_type dropped = std::min(size_, size_ + n - capacity_);
+
+            ReportOverwrites(0, dropped);
+            DropFront(dropped);
         }
 
-        for (auto it = q; it != this->end(); ++it) {
-            *it = *(it + 1);
+        // Leading items that would be overwritten within this call are
+        // skipped, but still count as pushed and overwritten.
+        if (n > capacity_) {
+            if constexpr (Stats::kEnabled) {
+                ForwardIterator it = first;
+
+                for (size_type i = 0; i < n - capacity_; ++i, ++it) {
+                    stats_.OnOverwrite(static_cast<const_reference>(*it));
+                }
+            }
+
+            std::advance(first, n - capacity_);
+            n = capacity_;
         }
 
-        --this->size_;
-        this->end_pos_ = this->GetPrevPosition(this->end_pos_);
+        size_type slot = GetSlot(end_pos_);
+        size_type first_run = std::min(n, real_capacity_ - slot);
 
-        return q;
+        first = ConstructRun(first, first_run, data_ + slot);
+        ConstructRun(first, n - first_run, data_);
+
+        end_pos_ = Indexing::Advance(end_pos_, n, real_capacity_);
+        size_ += n;
+        stats_.OnPush(pushed, size_);
     }
 
-    iterator erase(iterator q1, iterator q2) {
-        size_type removed = q2 - q1;
+    template<typename ForwardIterator>
+    ForwardIterator ConstructRun(ForwardIterator first, size_type n, value_type* to) {
+        if constexpr (
+            std::contiguous_iterator<ForwardIterator> &&
+            std::is_same_v<std::iter_value_t<ForwardIterator>, value_type> &&
+            std::is_trivially_copyable_v<value_type>
+        ) {
+            if (n != 0) {
+                std::memcpy(to, std::to_address(first), n * sizeof(value_type));
+            }
 
-        if (this->empty() || this->size_ < removed || q1 >= end() || q2 >= end()) {
-            throw std::runtime_error("Cannot erase non-existing element");
-        }
+            return first + n;
+        } else {
+            for (size_type i = 0; i < n; ++i) {
+                AllocTraits::construct(alloc_, to + i, *first);
+                ++first;
+            }
 
-        for (auto it = q1; it + removed != this->end(); ++it) {
-            *it = *(it + removed);
+            return first;
         }
+    }
 
-        this->size_ -= removed;
-        this->end_pos_ = ((this->end_pos_ - removed) % this->real_capacity_ + this->real_capacity_) % this->real_capacity_;
-
-        return q1;
+    void MoveOutRun(value_type* from, size_type n, value_type* to) {
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            if (n != 0) {
+                std::memcpy(to, from, n * sizeof(value_type));
+            }
+        } else {
+            for (size_type i = 0; i < n; ++i) {
+                to[i] = std::move(from[i]);
+                AllocTraits::destroy(alloc_, from + i);
+            }
+        }
     }
 
-    void push_front(const_reference element) override {
-        this->begin_pos_ = this->GetPrevPosition(this->begin_pos_);
+    // Reports the `n` elements from logical `index` on as overwritten; the
+    // loop is compiled only for policies that count.
+    void ReportOverwrites(size_type index, size_type n) {
+        if constexpr (Stats::kEnabled) {
+            for (size_type i = index; i < index + n; ++i) {
+                stats_.OnOverwrite(data_[GetSlot(GetPosition(i))]);
+            }
+        }
+    }
 
-        if (this->size_ == this->capacity_) {
-            this->reserve(this->capacity_ * 2);
+    void DropFront(size_type n) {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < n; ++i) {
+                AllocTraits::destroy(alloc_, data_ + GetSlot(GetPosition(i)));
+            }
         }
 
-        this->data_[this->begin_pos_] = element;
-        ++this->size_;
+        begin_pos_ = Indexing::Advance(begin_pos_, n, real_capacity_);
+        size_ -= n;
     }
 
-    void push_back(const_reference element) override {
-        if (this->size_ == this->capacity_) {
-            this->reserve(this->capacity_ * 2);
+    void DropBack(size_type n) {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = size_ - n; i < size_; ++i) {
+                AllocTraits::destroy(alloc_, data_ + GetSlot(GetPosition(i)));
+            }
         }
 
-        this->data_[this->size_] = element;
-        this->end_pos_ = this->GetNextPosition(this->end_pos_);
-        ++this->size_;
+        end_pos_ = Indexing::Retreat(end_pos_, n, real_capacity_);
+        size_ -= n;
+    }
+
+    size_type GetSlot(size_type pos) const {
+        return Indexing::Slot(pos, real_capacity_);
+    }
+
+    size_type GetFirstSegmentSize() const {
+        return std::min(size_, real_capacity_ - GetSlot(begin_pos_));
+    }
+
+    size_type GetPosition(size_type index) const {
+        return Indexing::Advance(begin_pos_, index, real_capacity_);
+    }
+
+    size_type GetPrevPosition(size_type pos) const {
+        return Indexing::Retreat(pos, 1, real_capacity_);
+    }
+
+    size_type GetNextPosition(size_type pos) const {
+        return Indexing::Advance(pos, 1, real_capacity_);
     }
 };
+
+template<
+    typename T,
+    typename Allocator = std::allocator<T>,
+    typename Stats = NoStats,
+    typename Storage = HeapStorage
+>
+class CircularBufferExt : public CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage> {
+public:
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using iterator         = BufferIterator<CircularBufferExt<T, Allocator, Stats, Storage>>;
+    using const_iterator   = BufferIterator<const CircularBufferExt<T, Allocator, Stats, Storage>>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type   = Allocator;
+protected:
+    using AllocTraits      = typename CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::AllocTraits;
+public:
+    CircularBufferExt()
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>()
+    {}
+
+    explicit CircularBufferExt(const Allocator& alloc)
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(alloc)
+    {}
+
+    CircularBufferExt(size_type capacity, const Allocator& alloc = Allocator())
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(capacity, alloc)
+    {}
+
+    CircularBufferExt(size_type size, const_reference fill_with, const Allocator& alloc = Allocator())
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(size, fill_with, alloc)
+    {}
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    CircularBufferExt(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(first, last, alloc)
+    {}
+
+    CircularBufferExt(const std::initializer_list<value_type>& init_list, const Allocator& alloc = Allocator())
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(init_list, alloc)
+    {}
+
+    CircularBufferExt(const CircularBufferExt<value_type, Allocator, Stats, Storage>& other)
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(other)
+        , growth_factor_(other.growth_factor_)
+        , max_capacity_(other.max_capacity_)
+    {}
+
+    CircularBufferExt(const CircularBufferExt<value_type, Allocator, Stats, Storage>& other, const Allocator& alloc)
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(other, alloc)
+        , growth_factor_(other.growth_factor_)
+        , max_capacity_(other.max_capacity_)
+    {}
+
+    CircularBufferExt(CircularBufferExt<value_type, Allocator, Stats, Storage>&& other) noexcept(CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::kNothrowMove)
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(std::move(other))
+        , growth_factor_(other.growth_factor_)
+        , max_capacity_(other.max_capacity_)
+    {}
+
+    CircularBufferExt(CircularBufferExt<value_type, Allocator, Stats, Storage>&& other, const Allocator& alloc)
+        : CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>(std::move(other), alloc)
+        , growth_factor_(other.growth_factor_)
+        , max_capacity_(other.max_capacity_)
+    {}
+
+    CircularBufferExt& operator=(const CircularBufferExt<value_type, Allocator, Stats, Storage>& other) {
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::operator=(other);
+        growth_factor_ = other.growth_factor_;
+        max_capacity_ = other.max_capacity_;
+
+        return *this;
+    }
+
+    CircularBufferExt& operator=(CircularBufferExt<value_type, Allocator, Stats, Storage>&& other) noexcept(
+        (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) &&
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::kNothrowMove
+    ) {
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::operator=(std::move(other));
+        growth_factor_ = other.growth_factor_;
+        max_capacity_ = other.max_capacity_;
+
+        return *this;
+    }
+
+    CircularBufferExt& operator=(const std::initializer_list<value_type>& other) {
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::operator=(other);
+
+        return *this;
+    }
+
+    void swap(CircularBufferExt& other) noexcept(CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::kNothrowMove) {
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::swap(other);
+        std::swap(growth_factor_, other.growth_factor_);
+        std::swap(max_capacity_, other.max_capacity_);
+    }
+
+    friend void swap(CircularBufferExt& lhs, CircularBufferExt& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+        lhs.swap(rhs);
+    }
+public:
+    iterator begin() {
+        return iterator(this, 0);
+    }
+
+    iterator end() {
+        return iterator(this, this->size_);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, this->size_);
+    }
+
+    const_iterator cbegin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cend() const {
+        return const_iterator(this, this->size_);
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const {
+        return rend();
+    }
+public:
+    iterator insert(iterator p, const_reference t) {
+        return emplace(p, t);
+    }
+
+    iterator insert(iterator p, value_type&& t) {
+        return emplace(p, std::move(t));
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator p, Args&&... args) {
+        size_type index = p - begin();
+        value_type value(std::forward<Args>(args)...);
+
+        Fit(this->size_ + 1);
+        this->InsertAt(index, 1, [&value]() -> value_type&& { return std::move(value); });
+
+        return begin() + index;
+    }
+
+    iterator insert(iterator p, size_type n, const_reference t) {
+        size_type index = p - begin();
+        value_type value(t);
+
+        Fit(this->size_ + n);
+        this->InsertAt(index, n, [&value]() -> const_reference { return value; });
+
+        return begin() + index;
+    }
+    
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    iterator insert(iterator p, InputIterator first, InputIterator last) {
+        size_type index = p - begin();
+        size_type n = std::distance(first, last);
+
+        Fit(this->size_ + n);
+        this->InsertAt(index, n, [&first]() -> typename std::iterator_traits<InputIterator>::reference {
+            InputIterator current = first;
+            ++first;
+
+            return *current;
+        });
+
+        return begin() + index;
+    }
+
+    iterator insert(iterator p, const std::initializer_list<value_type>& init_list) {
+        return insert(p, init_list.begin(), init_list.end());
+    }
+
+    iterator erase(iterator q) {
+        if (this->empty() || q >= end()) {
+            throw std::runtime_error("Cannot erase non-existing element");
+        }
+
+        size_type index = q - begin();
+        this->EraseAt(index, 1);
+
+        return begin() + index;
+    }
+
+    iterator erase(iterator q1, iterator q2) {
+        size_type removed = q2 - q1;
+
+        if (this->empty() || this->size_ < removed || q1 >= end() || q2 > end()) {
+            throw std::runtime_error("Cannot erase non-existing element");
+        }
+
+        size_type index = q1 - begin();
+        this->EraseAt(index, removed);
+
+        return begin() + index;
+    }
+
+    void push_front(const_reference element) override {
+        emplace_front(element);
+    }
+
+    void push_front(value_type&& element) override {
+        emplace_front(std::move(element));
+    }
+
+    void push_back(const_reference element) override {
+        emplace_back(element);
+    }
+
+    void push_back(value_type&& element) override {
+        emplace_back(std::move(element));
+    }
+
+    void push_back_n(const value_type* items, size_type n) override {
+        Fit(this->size_ + n);
+        CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::push_back_n(items, n);
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    void append(InputIterator first, InputIterator last) {
+        if constexpr (std::forward_iterator<InputIterator>) {
+            Fit(this->size_ + std::distance(first, last));
+            CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::append(first, last);
+        } else {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    // Once max_capacity() is reached the buffer stops growing and behaves
+    // like CircularBuffer, overwriting the element at the opposite end.
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        if (this->size_ == this->capacity_ && this->capacity_ < max_capacity_) {
+            value_type value(std::forward<Args>(args)...);
+
+            Grow();
+            CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::emplace_front(std::move(value));
+        } else {
+            CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::emplace_front(std::forward<Args>(args)...);
+        }
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (this->size_ == this->capacity_ && this->capacity_ < max_capacity_) {
+            value_type value(std::forward<Args>(args)...);
+
+            Grow();
+            CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::emplace_back(std::move(value));
+        } else {
+            CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::emplace_back(std::forward<Args>(args)...);
+        }
+    }
+
+    // Grows first, so all `n` slots are available unless max_capacity()
+    // is reached.
+    RingSpans<value_type> prepare(size_type n) {
+        Fit(this->size_ + n);
+
+        return CircularBuffer<T, Allocator, ModuloIndexing, Stats, Storage>::prepare(n);
+    }
+public:
+    // Never below the inline capacity: those slots are there anyway.
+    void shrink_to_fit() {
+        size_type target = std::max(this->size_, this->kInlineCapacity);
+
+        if (ModuloIndexing::Slots(target) < this->real_capacity_) {
+            this->Reallocate(target);
+        }
+    }
+
+    double growth_factor() const {
+        return growth_factor_;
+    }
+
+    void set_growth_factor(double factor) {
+        if (!(factor > 1.0)) {
+            throw std::invalid_argument("Growth factor must be greater than 1.");
+        }
+
+        growth_factor_ = factor;
+    }
+
+    size_type max_capacity() const {
+        return max_capacity_;
+    }
+
+    void set_max_capacity(size_type n) {
+        if (n < this->capacity_) {
+            throw std::invalid_argument("Maximum capacity cannot be less than the current capacity.");
+        }
+
+        max_capacity_ = n;
+    }
+protected:
+    // Geometric growth keeps push_back amortized O(1); each step adds at
+    // least one slot so small capacities still make progress.
+    void Grow() {
+        size_type grown = static_cast<size_type>(static_cast<double>(this->capacity_) * growth_factor_);
+
+        this->reserve(std::min(std::max(grown, this->capacity_ + 1), max_capacity_));
+    }
+
+    void Fit(size_type n) {
+        while (this->capacity_ < n && this->capacity_ < max_capacity_) {
+            Grow();
+        }
+    }
+protected:
+    double growth_factor_ = 2.0;
+    size_type max_capacity_ = std::numeric_limits<size_type>::max() / sizeof(value_type);
+};
+
+// Index layouts for SpscCircularBuffer. CacheLineLayout gives the
+// read-only fields, the consumer's and the producer's index one cache line
+// each, so the two threads only exchange lines when they actually look at
+// each other's index. PackedLayout keeps everything in one or two lines and
+// exists mainly to measure what false sharing costs.
+struct CacheLineLayout {
+    static constexpr std::size_t kIndexAlignment = 64;
+};
+
+struct PackedLayout {
+    static constexpr std::size_t kIndexAlignment = alignof(std::size_t);
+};
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// Storage is laid out like CircularBuffer with PowerOfTwoIndexing: the head
+// and tail are free-running counters and a slot is `counter & mask`. Each
+// side owns its index (on a separate cache line with the default layout) and
+// keeps a local copy of the other side's index, refreshing it only when the
+// ring looks full or empty.
+template<
+    typename T,
+    typename Allocator = std::allocator<T>,
+    typename Layout = CacheLineLayout
+>
+class SpscCircularBuffer {
+public:
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+public:
+    explicit SpscCircularBuffer(size_type capacity, const Allocator& alloc = Allocator())
+        : capacity_(PowerOfTwoIndexing::Capacity(capacity))
+        , real_capacity_(PowerOfTwoIndexing::Slots(capacity_))
+        , alloc_(alloc)
+        , head_(0)
+        , cached_tail_(0)
+        , tail_(0)
+        , cached_head_(0)
+    {
+        data_ = AllocTraits::allocate(alloc_, real_capacity_);
+    }
+
+    SpscCircularBuffer(const SpscCircularBuffer&) = delete;
+    SpscCircularBuffer& operator=(const SpscCircularBuffer&) = delete;
+
+    ~SpscCircularBuffer() {
+        size_type tail = tail_.load(std::memory_order_relaxed);
+
+        for (size_type pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+            AllocTraits::destroy(alloc_, data_ + GetSlot(pos));
+        }
+
+        AllocTraits::deallocate(alloc_, data_, real_capacity_);
+    }
+public:
+    // Producer side.
+    bool try_push(const_reference element) {
+        return try_emplace(element);
+    }
+
+    bool try_push(value_type&& element) {
+        return try_emplace(std::move(element));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_type tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cached_head_ == capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+
+            if (tail - cached_head_ == capacity_) {
+                return false;
+            }
+        }
+
+        AllocTraits::construct(alloc_, data_ + GetSlot(tail), std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Pushes as many elements of [first, last) as fit and publishes them
+    // with a single store. Returns the number of elements pushed. Needs a
+    // forward range: the caller resumes from first + n with what was left.
+    template<std::forward_iterator ForwardIterator>
+    size_type try_push_bulk(ForwardIterator first, ForwardIterator last) {
+        size_type tail = tail_.load(std::memory_order_relaxed);
+        size_type wanted = std::distance(first, last);
+
+        if (capacity_ - (tail - cached_head_) < wanted) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+
+        size_type n = std::min(wanted, capacity_ - (tail - cached_head_));
+
+        for (size_type i = 0; i < n; ++i) {
+            AllocTraits::construct(alloc_, data_ + GetSlot(tail + i), *first);
+            ++first;
+        }
+
+        tail_.store(tail + n, std::memory_order_release);
+
+        return n;
+    }
+
+    // Claims up to `n` free slots for writing in place; commit(k) publishes
+    // the first `k` of them with a single store. `k` must not exceed the
+    // size of the last prepare().
+    RingSpans<value_type> prepare(size_type n) {
+        static_assert(std::is_trivially_copyable_v<value_type>, "prepare() requires a trivially copyable type.");
+
+        size_type tail = tail_.load(std::memory_order_relaxed);
+
+        if (capacity_ - (tail - cached_head_) < n) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+
+        return Runs(tail, std::min(n, capacity_ - (tail - cached_head_)));
+    }
+
+    void commit(size_type k) {
+        static_assert(std::is_trivially_copyable_v<value_type>, "commit() requires a trivially copyable type.");
+
+        tail_.store(tail_.load(std::memory_order_relaxed) + k, std::memory_order_release);
+    }
+public:
+    // Consumer side.
+    bool try_pop(reference out) {
+        size_type head = head_.load(std::memory_order_relaxed);
+
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+
+        value_type* slot = data_ + GetSlot(head);
+
+        out = std::move(*slot);
+        AllocTraits::destroy(alloc_, slot);
+        head_.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Moves up to `max_n` elements into `out` and releases their slots with
+    // a single store. Returns the number of elements popped.
+    template<typename OutputIterator>
+    size_type try_pop_bulk(OutputIterator out, size_type max_n) {
+        size_type head = head_.load(std::memory_order_relaxed);
+
+        if (cached_tail_ - head < max_n) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+
+        size_type n = std::min(max_n, cached_tail_ - head);
+
+        for (size_type i = 0; i < n; ++i) {
+            value_type* slot = data_ + GetSlot(head + i);
+
+            *out = std::move(*slot);
+            ++out;
+            AllocTraits::destroy(alloc_, slot);
+        }
+
+        head_.store(head + n, std::memory_order_release);
+
+        return n;
+    }
+
+    // Exposes up to `n` published elements in place; consume(k) releases
+    // the first `k` of them with a single store. `k` must not exceed the
+    // size of the last peek().
+    RingSpans<value_type> peek(size_type n) {
+        size_type head = head_.load(std::memory_order_relaxed);
+
+        if (cached_tail_ - head < n) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+
+        return Runs(head, std::min(n, cached_tail_ - head));
+    }
+
+    void consume(size_type k) {
+        size_type head = head_.load(std::memory_order_relaxed);
+
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < k; ++i) {
+                AllocTraits::destroy(alloc_, data_ + GetSlot(head + i));
+            }
+        }
+
+        head_.store(head + k, std::memory_order_release);
+    }
+public:
+    // Both observers are exact only when called from one of the two sides
+    // while the other one is idle.
+    size_type size() const {
+        size_type head = head_.load(std::memory_order_acquire);
+
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type capacity() const {
+        return capacity_;
+    }
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+private:
+    size_type GetSlot(size_type pos) const {
+        return PowerOfTwoIndexing::Slot(pos, real_capacity_);
+    }
+
+    RingSpans<value_type> Runs(size_type pos, size_type n) const {
+        size_type slot = GetSlot(pos);
+        size_type first_run = std::min(n, real_capacity_ - slot);
+
+        return {std::span<value_type>(data_ + slot, first_run), std::span<value_type>(data_, n - first_run)};
+    }
+private:
+    size_type capacity_;
+    size_type real_capacity_;
+    value_type* data_;
+    Allocator alloc_;
+private:
+    alignas(Layout::kIndexAlignment) std::atomic<size_type> head_;
+    size_type cached_tail_;
+private:
+    alignas(Layout::kIndexAlignment) std::atomic<size_type> tail_;
+    size_type cached_head_;
+};
+
+// What a bounded concurrent ring does with a push that finds it full.
+enum class OverflowPolicy {
+    Reject,
+    Overwrite,
+};
+
+// Spins with an exponentially growing number of pause instructions and
+// falls back to yielding the thread once the spin limit is reached.
+class Backoff {
+public:
+    void Pause() {
+        if (spins_ > kSpinLimit) {
+            std::this_thread::yield();
+            return;
+        }
+
+        for (std::size_t i = 0; i < spins_; ++i) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        spins_ <<= 1;
+    }
+private:
+    static constexpr std::size_t kSpinLimit = 64;
+
+    std::size_t spins_ = 1;
+};
+
+// Bounded multi-producer/multi-consumer ring in the style of D. Vyukov's
+// queue: every slot carries a sequence number that tells producers and
+// consumers whose turn it is, so the only shared writes are one CAS on the
+// head or tail counter per operation. With OverflowPolicy::Overwrite a push
+// into a full ring drops the oldest element, like CircularBuffer::push_back.
+template<
+    typename T,
+    typename Allocator = std::allocator<T>
+>
+class MpmcCircularBuffer {
+public:
+    using value_type       = typename std::allocator_traits<Allocator>::value_type;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using difference_type  = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type        = typename std::allocator_traits<Allocator>::size_type;
+public:
+    static constexpr size_type kCacheLineSize = 64;
+private:
+    struct Slot {
+        std::atomic<size_type> sequence;
+        alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+        value_type* value() {
+            return reinterpret_cast<value_type*>(storage);
+        }
+    };
+
+    using AllocTraits   = std::allocator_traits<Allocator>;
+    using SlotAllocator = typename AllocTraits::template rebind_alloc<Slot>;
+    using SlotAllocTraits = std::allocator_traits<SlotAllocator>;
+public:
+    explicit MpmcCircularBuffer(size_type capacity, OverflowPolicy policy = OverflowPolicy::Reject, const Allocator& alloc = Allocator())
+        : capacity_(std::max<size_type>(PowerOfTwoIndexing::Capacity(capacity), 2))
+        , policy_(policy)
+        , alloc_(alloc)
+        , slot_alloc_(alloc)
+        , head_(0)
+        , tail_(0)
+    {
+        slots_ = SlotAllocTraits::allocate(slot_alloc_, capacity_);
+
+        for (size_type i = 0; i < capacity_; ++i) {
+            new (&slots_[i].sequence) std::atomic<size_type>(i);
+        }
+    }
+
+    MpmcCircularBuffer(const MpmcCircularBuffer&) = delete;
+    MpmcCircularBuffer& operator=(const MpmcCircularBuffer&) = delete;
+
+    ~MpmcCircularBuffer() {
+        while (TryConsume([](value_type&) {})) {}
+
+        for (size_type i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.~atomic();
+        }
+
+        SlotAllocTraits::deallocate(slot_alloc_, slots_, capacity_);
+    }
+public:
+    bool try_push(const_reference element) {
+        return try_emplace(element);
+    }
+
+    bool try_push(value_type&& element) {
+        return try_emplace(std::move(element));
+    }
+
+    // Never fails with OverflowPolicy::Overwrite: the oldest elements are
+    // discarded until the new one fits.
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        if (policy_ == OverflowPolicy::Reject) {
+            return TryEmplace(std::forward<Args>(args)...);
+        }
+
+        while (!TryEmplace(std::forward<Args>(args)...)) {
+            TryConsume([](value_type&) {});
+        }
+
+        return true;
+    }
+
+    void push_wait(const_reference element) {
+        Backoff backoff;
+
+        while (!try_push(element)) {
+            backoff.Pause();
+        }
+    }
+
+    void push_wait(value_type&& element) {
+        Backoff backoff;
+
+        while (!try_push(std::move(element))) {
+            backoff.Pause();
+        }
+    }
+
+    bool try_pop(reference out) {
+        return TryConsume([&out](value_type& value) { out = std::move(value); });
+    }
+
+    void pop_wait(reference out) {
+        Backoff backoff;
+
+        while (!try_pop(out)) {
+            backoff.Pause();
+        }
+    }
+public:
+    // Approximate while other threads are pushing or popping.
+    size_type size() const {
+        size_type head = head_.load(std::memory_order_acquire);
+        size_type tail = tail_.load(std::memory_order_acquire);
+
+        return tail > head ? std::min(tail - head, capacity_) : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_type capacity() const {
+        return capacity_;
+    }
+
+    OverflowPolicy policy() const {
+        return policy_;
+    }
+private:
+    template<typename... Args>
+    bool TryEmplace(Args&&... args) {
+        size_type pos = tail_.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &slots_[PowerOfTwoIndexing::Slot(pos, capacity_)];
+            size_type sequence = slot->sequence.load(std::memory_order_acquire);
+            difference_type diff = static_cast<difference_type>(sequence - pos);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        AllocTraits::construct(alloc_, slot->value(), std::forward<Args>(args)...);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    template<typename Consumer>
+    bool TryConsume(Consumer consume) {
+        size_type pos = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &slots_[PowerOfTwoIndexing::Slot(pos, capacity_)];
+            size_type sequence = slot->sequence.load(std::memory_order_acquire);
+            difference_type diff = static_cast<difference_type>(sequence - (pos + 1));
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        consume(*slot->value());
+        AllocTraits::destroy(alloc_, slot->value());
+        slot->sequence.store(pos + capacity_, std::memory_order_release);
+
+        return true;
+    }
+private:
+    size_type capacity_;
+    OverflowPolicy policy_;
+    Slot* slots_;
+    Allocator alloc_;
+    SlotAllocator slot_alloc_;
+private:
+    alignas(kCacheLineSize) std::atomic<size_type> head_;
+private:
+    alignas(kCacheLineSize) std::atomic<size_type> tail_;
+};
+
+// Ring of capacity N (or less, if constructed so) kept entirely inside the
+// object: it never allocates, and asking for a larger capacity throws.
+template<typename T, std::size_t N, typename Indexing = ModuloIndexing>
+using StaticCircularBuffer = CircularBuffer<T, std::allocator<T>, Indexing, NoStats, FixedStorage<N>>;
+
+// Growable ring that keeps up to N elements inline and moves to the heap
+// only when it grows past them; shrink_to_fit() brings it back inline.
+template<typename T, std::size_t N, typename Allocator = std::allocator<T>>
+using SmallCircularBuffer = CircularBufferExt<T, Allocator, NoStats, InlineStorage<N>>;
+
+// Buffers drawing from a std::pmr::memory_resource, like std::pmr::vector.
+namespace cb::pmr {
+
+template<typename T, typename Indexing = ModuloIndexing>
+using CircularBuffer = ::CircularBuffer<T, std::pmr::polymorphic_allocator<T>, Indexing>;
+
+template<typename T>
+using CircularBufferExt = ::CircularBufferExt<T, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace cb::pmr
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <utility>
+
+// Segment-aware algorithms for ring buffers. A buffer's content is at most
+// two contiguous runs (array_one() and array_two()), so each algorithm runs
+// the plain pointer version over every run instead of paying the wrap check
+// of BufferIterator on every step. Works with any container exposing
+// array_one()/array_two(): CircularBuffer, CircularBufferExt and
+// MirroredCircularBuffer.
+namespace cb {
+
+template<typename Buffer>
+concept SegmentedBuffer = requires(Buffer& buffer) {
+    buffer.array_one();
+    buffer.array_two();
+};
+
+namespace detail {
+
+// Walks two segmented buffers of the same size in lockstep, calling
+// `f(lhs, rhs, n)` on every pair of runs that are contiguous on both sides.
+// Stops as soon as `f` returns false.
+template<typename Lhs, typename Rhs, typename F>
+bool ForEachRunPair(Lhs& lhs, Rhs& rhs, F f) {
+    auto lhs_runs = {lhs.array_one(), lhs.array_two()};
+    auto rhs_runs = {rhs.array_one(), rhs.array_two()};
+    auto lhs_run = lhs_runs.begin();
+    auto rhs_run = rhs_runs.begin();
+    std::size_t lhs_offset = 0;
+    std::size_t rhs_offset = 0;
+
+    while (lhs_run != lhs_runs.end() && rhs_run != rhs_runs.end()) {
+        std::size_t n = std::min(lhs_run->size() - lhs_offset, rhs_run->size() - rhs_offset);
+
+        if (n != 0 && !f(lhs_run->data() + lhs_offset, rhs_run->data() + rhs_offset, n)) {
+            return false;
+        }
+
+        lhs_offset += n;
+        rhs_offset += n;
+
+        if (lhs_offset == lhs_run->size()) {
+            ++lhs_run;
+            lhs_offset = 0;
+        }
+
+        if (rhs_offset == rhs_run->size()) {
+            ++rhs_run;
+            rhs_offset = 0;
+        }
+    }
+
+    return true;
+}
+
+} // namespace detail
+
+template<SegmentedBuffer Buffer, typename UnaryFunction>
+UnaryFunction for_each(Buffer& buffer, UnaryFunction f) {
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    return std::for_each(second.begin(), second.end(), std::for_each(first.begin(), first.end(), std::move(f)));
+}
+
+template<SegmentedBuffer Buffer, typename OutputIterator>
+OutputIterator copy(const Buffer& buffer, OutputIterator out) {
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    out = std::copy(first.begin(), first.end(), out);
+
+    return std::copy(second.begin(), second.end(), out);
+}
+
+template<SegmentedBuffer Buffer, typename T>
+void fill(Buffer& buffer, const T& value) {
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    std::fill(first.begin(), first.end(), value);
+    std::fill(second.begin(), second.end(), value);
+}
+
+// Returns an iterator of `buffer`, end() if nothing matches.
+template<SegmentedBuffer Buffer, typename UnaryPredicate>
+auto find_if(Buffer& buffer, UnaryPredicate p) {
+    auto first = buffer.array_one();
+    auto found = std::find_if(first.begin(), first.end(), p);
+
+    if (found != first.end()) {
+        return buffer.begin() + (found - first.begin());
+    }
+
+    auto second = buffer.array_two();
+    found = std::find_if(second.begin(), second.end(), p);
+
+    return buffer.begin() + (static_cast<std::ptrdiff_t>(first.size()) + (found - second.begin()));
+}
+
+template<SegmentedBuffer Buffer, typename T>
+auto find(Buffer& buffer, const T& value) {
+    return cb::find_if(buffer, [&value](const auto& element) { return element == value; });
+}
+
+template<SegmentedBuffer Buffer, typename T, typename BinaryOperation>
+T accumulate(const Buffer& buffer, T init, BinaryOperation op) {
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    init = std::accumulate(first.begin(), first.end(), std::move(init), op);
+
+    return std::accumulate(second.begin(), second.end(), std::move(init), op);
+}
+
+template<SegmentedBuffer Buffer, typename T>
+T accumulate(const Buffer& buffer, T init) {
+    return cb::accumulate(buffer, std::move(init), std::plus<>());
+}
+
+// Compares the whole buffer with the range starting at `first2`, which must
+// hold at least buffer.size() elements.
+template<SegmentedBuffer Buffer, std::forward_iterator ForwardIterator>
+bool equal(const Buffer& buffer, ForwardIterator first2) {
+    auto first = buffer.array_one();
+
+    if (!std::equal(first.begin(), first.end(), first2)) {
+        return false;
+    }
+
+    auto second = buffer.array_two();
+    std::advance(first2, first.size());
+
+    return std::equal(second.begin(), second.end(), first2);
+}
+
+// Two segmented buffers are compared run against run, so neither side goes
+// through its iterator.
+template<SegmentedBuffer Lhs, SegmentedBuffer Rhs>
+bool equal(const Lhs& lhs, const Rhs& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+
+    return detail::ForEachRunPair(lhs, rhs, [](const auto* a, const auto* b, std::size_t n) {
+        return std::equal(a, a + n, b);
+    });
+}
+
+} // namespace cb
@@ -0,0 +1,543 @@
+#pragma once
+
+#include "circular_buffer_algorithms.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CBUFFER_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CBUFFER_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// SIMD reductions and searches over numeric ring buffers (float, double and
+// int64_t). Every operation runs a vector kernel on each of the at most two
+// contiguous segments of the buffer. The kernel set is picked once at run
+// time: AVX2 or SSE4.2 on x86 (detected through cpuid), NEON on AArch64,
+// plain loops otherwise. Floating-point sums may round differently from a
+// sequential loop, and min/max of data containing NaN is unspecified.
+namespace cb::simd {
+
+enum class Isa {
+    Scalar,
+    Sse42,
+    Avx2,
+    Neon,
+};
+
+template<typename T>
+struct Kernels {
+    T (*sum)(const T*, std::size_t);
+    T (*min)(const T*, std::size_t);
+    T (*max)(const T*, std::size_t);
+    std::size_t (*count_greater)(const T*, std::size_t, T);
+    std::size_t (*find)(const T*, std::size_t, T);
+    T (*dot)(const T*, const T*, std::size_t);
+};
+
+namespace detail {
+
+namespace scalar {
+
+template<typename T>
+T Sum(const T* p, std::size_t n) {
+    T result = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        result += p[i];
+    }
+
+    return result;
+}
+
+template<typename T>
+T Min(const T* p, std::size_t n) {
+    T result = p[0];
+
+    for (std::size_t i = 1; i < n; ++i) {
+        result = p[i] < result ? p[i] : result;
+    }
+
+    return result;
+}
+
+template<typename T>
+T Max(const T* p, std::size_t n) {
+    T result = p[0];
+
+    for (std::size_t i = 1; i < n; ++i) {
+        result = p[i] > result ? p[i] : result;
+    }
+
+    return result;
+}
+
+template<typename T>
+std::size_t CountGreater(const T* p, std::size_t n, T x) {
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        count += p[i] > x;
+    }
+
+    return count;
+}
+
+template<typename T>
+std::size_t Find(const T* p, std::size_t n, T value) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (p[i] == value) {
+            return i;
+        }
+    }
+
+    return n;
+}
+
+template<typename T>
+T Dot(const T* a, const T* b, std::size_t n) {
+    T result = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        result += a[i] * b[i];
+    }
+
+    return result;
+}
+
+template<typename T>
+inline constexpr Kernels<T> kKernels = {
+    &Sum<T>,
+    &Min<T>,
+    &Max<T>,
+    &CountGreater<T>,
+    &Find<T>,
+    &Dot<T>,
+};
+
+} // namespace scalar
+
+#if defined(CBUFFER_SIMD_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2,popcnt"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+#endif
+
+namespace sse42 {
+
+struct FloatOps {
+    using Scalar = float;
+    using Vec = __m128;
+    static constexpr std::size_t kLanes = 4;
+
+    static Vec Load(const Scalar* p) { return _mm_loadu_ps(p); }
+    static void Store(Scalar* p, Vec v) { _mm_storeu_ps(p, v); }
+    static Vec Broadcast(Scalar x) { return _mm_set1_ps(x); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+};
+
+struct DoubleOps {
+    using Scalar = double;
+    using Vec = __m128d;
+    static constexpr std::size_t kLanes = 2;
+
+    static Vec Load(const Scalar* p) { return _mm_loadu_pd(p); }
+    static void Store(Scalar* p, Vec v) { _mm_storeu_pd(p, v); }
+    static Vec Broadcast(Scalar x) { return _mm_set1_pd(x); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+};
+
+// 64-bit compares are what SSE4.2 adds over SSE4.1; there is no packed
+// 64-bit multiply, so Mul is assembled from 32x32->64 products.
+struct Int64Ops {
+    using Scalar = std::int64_t;
+    using Vec = __m128i;
+    static constexpr std::size_t kLanes = 2;
+
+    static Vec Load(const Scalar* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void Store(Scalar* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec Broadcast(Scalar x) { return _mm_set1_epi64x(x); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); }
+    static Vec Max(Vec a, Vec b) { return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+
+    static Vec Mul(Vec a, Vec b) {
+        Vec low = _mm_mul_epu32(a, b);
+        Vec cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+
+        return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+    }
+
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(a, b))); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a, b))); }
+};
+
+#include "circular_buffer_simd_kernels.inc"
+
+} // namespace sse42
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx2,popcnt"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+#endif
+
+namespace avx2 {
+
+struct FloatOps {
+    using Scalar = float;
+    using Vec = __m256;
+    static constexpr std::size_t kLanes = 8;
+
+    static Vec Load(const Scalar* p) { return _mm256_loadu_ps(p); }
+    static void Store(Scalar* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static Vec Broadcast(Scalar x) { return _mm256_set1_ps(x); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+};
+
+struct DoubleOps {
+    using Scalar = double;
+    using Vec = __m256d;
+    static constexpr std::size_t kLanes = 4;
+
+    static Vec Load(const Scalar* p) { return _mm256_loadu_pd(p); }
+    static void Store(Scalar* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static Vec Broadcast(Scalar x) { return _mm256_set1_pd(x); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+    static Vec Max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+};
+
+struct Int64Ops {
+    using Scalar = std::int64_t;
+    using Vec = __m256i;
+    static constexpr std::size_t kLanes = 4;
+
+    static Vec Load(const Scalar* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void Store(Scalar* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec Broadcast(Scalar x) { return _mm256_set1_epi64x(x); }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Vec Min(Vec a, Vec b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static Vec Max(Vec a, Vec b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+
+    static Vec Mul(Vec a, Vec b) {
+        Vec low = _mm256_mul_epu32(a, b);
+        Vec cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+
+        return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+    }
+
+    static unsigned GreaterMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))); }
+    static unsigned EqualMask(Vec a, Vec b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))); }
+};
+
+#include "circular_buffer_simd_kernels.inc"
+
+} // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#elif defined(CBUFFER_SIMD_NEON)
+
+// NEON is part of the AArch64 baseline, no target region is needed.
+namespace neon {
+
+inline unsigned ToMask(uint32x4_t m) {
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m, bits));
+}
+
+inline unsigned ToMask(uint64x2_t m) {
+    const uint64x2_t bits = {1, 2};
+    return static_cast<unsigned>(vaddvq_u64(vandq_u64(m, bits)));
+}
+
+struct FloatOps {
+    using Scalar = float;
+    using Vec = float32x4_t;
+    static constexpr std::size_t kLanes = 4;
+
+    static Vec Load(const Scalar* p) { return vld1q_f32(p); }
+    static void Store(Scalar* p, Vec v) { vst1q_f32(p, v); }
+    static Vec Broadcast(Scalar x) { return vdupq_n_f32(x); }
+    static Vec Add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static Vec Mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+    static Vec Min(Vec a, Vec b) { return vminq_f32(a, b); }
+    static Vec Max(Vec a, Vec b) { return vmaxq_f32(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return ToMask(vcgtq_f32(a, b)); }
+    static unsigned EqualMask(Vec a, Vec b) { return ToMask(vceqq_f32(a, b)); }
+};
+
+struct DoubleOps {
+    using Scalar = double;
+    using Vec = float64x2_t;
+    static constexpr std::size_t kLanes = 2;
+
+    static Vec Load(const Scalar* p) { return vld1q_f64(p); }
+    static void Store(Scalar* p, Vec v) { vst1q_f64(p, v); }
+    static Vec Broadcast(Scalar x) { return vdupq_n_f64(x); }
+    static Vec Add(Vec a, Vec b) { return vaddq_f64(a, b); }
+    static Vec Mul(Vec a, Vec b) { return vmulq_f64(a, b); }
+    static Vec Min(Vec a, Vec b) { return vminq_f64(a, b); }
+    static Vec Max(Vec a, Vec b) { return vmaxq_f64(a, b); }
+    static unsigned GreaterMask(Vec a, Vec b) { return ToMask(vcgtq_f64(a, b)); }
+    static unsigned EqualMask(Vec a, Vec b) { return ToMask(vceqq_f64(a, b)); }
+};
+
+struct Int64Ops {
+    using Scalar = std::int64_t;
+    using Vec = int64x2_t;
+    static constexpr std::size_t kLanes = 2;
+
+    static Vec Load(const Scalar* p) { return vld1q_s64(p); }
+    static void Store(Scalar* p, Vec v) { vst1q_s64(p, v); }
+    static Vec Broadcast(Scalar x) { return vdupq_n_s64(x); }
+    static Vec Add(Vec a, Vec b) { return vaddq_s64(a, b); }
+    static Vec Min(Vec a, Vec b) { return vbslq_s64(vcgtq_s64(a, b), b, a); }
+    static Vec Max(Vec a, Vec b) { return vbslq_s64(vcgtq_s64(a, b), a, b); }
+
+    // No 64-bit lane multiply in NEON.
+    static Vec Mul(Vec a, Vec b) {
+        Vec result = vdupq_n_s64(vgetq_lane_s64(a, 0) * vgetq_lane_s64(b, 0));
+        return vsetq_lane_s64(vgetq_lane_s64(a, 1) * vgetq_lane_s64(b, 1), result, 1);
+    }
+
+    static unsigned GreaterMask(Vec a, Vec b) { return ToMask(vcgtq_s64(a, b)); }
+    static unsigned EqualMask(Vec a, Vec b) { return ToMask(vceqq_s64(a, b)); }
+};
+
+#include "circular_buffer_simd_kernels.inc"
+
+} // namespace neon
+
+#endif
+
+inline Isa DetectIsa() {
+#if defined(CBUFFER_SIMD_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Isa::Sse42;
+    }
+#elif defined(CBUFFER_SIMD_NEON)
+    return Isa::Neon;
+#endif
+
+    return Isa::Scalar;
+}
+
+} // namespace detail
+
+template<typename T>
+concept SimdElement = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, std::int64_t>;
+
+// The instruction set chosen for this process.
+inline Isa active_isa() {
+    static const Isa isa = detail::DetectIsa();
+    return isa;
+}
+
+inline bool is_supported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+        case Isa::Sse42:
+            return active_isa() == Isa::Sse42 || active_isa() == Isa::Avx2;
+        default:
+            return active_isa() == isa;
+    }
+}
+
+// Kernels for a given instruction set, mostly for tests and benchmarks.
+// Throws if the CPU does not support it.
+template<SimdElement T>
+const Kernels<T>& kernels(Isa isa) {
+    if (!is_supported(isa)) {
+        throw std::runtime_error("The instruction set is not supported by this CPU.");
+    }
+
+    switch (isa) {
+#if defined(CBUFFER_SIMD_X86)
+        case Isa::Avx2:
+            if constexpr (std::is_same_v<T, float>) {
+                return detail::avx2::kKernels<detail::avx2::FloatOps>;
+            } else if constexpr (std::is_same_v<T, double>) {
+                return detail::avx2::kKernels<detail::avx2::DoubleOps>;
+            } else {
+                return detail::avx2::kKernels<detail::avx2::Int64Ops>;
+            }
+        case Isa::Sse42:
+            if constexpr (std::is_same_v<T, float>) {
+                return detail::sse42::kKernels<detail::sse42::FloatOps>;
+            } else if constexpr (std::is_same_v<T, double>) {
+                return detail::sse42::kKernels<detail::sse42::DoubleOps>;
+            } else {
+                return detail::sse42::kKernels<detail::sse42::Int64Ops>;
+            }
+#elif defined(CBUFFER_SIMD_NEON)
+        case Isa::Neon:
+            if constexpr (std::is_same_v<T, float>) {
+                return detail::neon::kKernels<detail::neon::FloatOps>;
+            } else if constexpr (std::is_same_v<T, double>) {
+                return detail::neon::kKernels<detail::neon::DoubleOps>;
+            } else {
+                return detail::neon::kKernels<detail::neon::Int64Ops>;
+            }
+#endif
+        default:
+            return detail::scalar::kKernels<T>;
+    }
+}
+
+template<SimdElement T>
+const Kernels<T>& kernels() {
+    static const Kernels<T>& active = kernels<T>(active_isa());
+    return active;
+}
+
+template<SegmentedBuffer Buffer>
+auto sum(const Buffer& buffer) {
+    using T = typename Buffer::value_type;
+
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    return static_cast<T>(kernels<T>().sum(first.data(), first.size()) + kernels<T>().sum(second.data(), second.size()));
+}
+
+template<SegmentedBuffer Buffer>
+double mean(const Buffer& buffer) {
+    if (buffer.empty()) {
+        throw std::runtime_error("Cannot access empty container.");
+    }
+
+    return static_cast<double>(cb::simd::sum(buffer)) / static_cast<double>(buffer.size());
+}
+
+template<SegmentedBuffer Buffer>
+auto min(const Buffer& buffer) {
+    using T = typename Buffer::value_type;
+
+    if (buffer.empty()) {
+        throw std::runtime_error("Cannot access empty container.");
+    }
+
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+    T result = kernels<T>().min(first.data(), first.size());
+
+    if (!second.empty()) {
+        T other = kernels<T>().min(second.data(), second.size());
+        result = other < result ? other : result;
+    }
+
+    return result;
+}
+
+template<SegmentedBuffer Buffer>
+auto max(const Buffer& buffer) {
+    using T = typename Buffer::value_type;
+
+    if (buffer.empty()) {
+        throw std::runtime_error("Cannot access empty container.");
+    }
+
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+    T result = kernels<T>().max(first.data(), first.size());
+
+    if (!second.empty()) {
+        T other = kernels<T>().max(second.data(), second.size());
+        result = other > result ? other : result;
+    }
+
+    return result;
+}
+
+// Number of elements greater than `x`.
+template<SegmentedBuffer Buffer>
+std::size_t count_greater(const Buffer& buffer, typename Buffer::value_type x) {
+    using T = typename Buffer::value_type;
+
+    auto first = buffer.array_one();
+    auto second = buffer.array_two();
+
+    return kernels<T>().count_greater(first.data(), first.size(), x) + kernels<T>().count_greater(second.data(), second.size(), x);
+}
+
+// Iterator to the first element equal to `value`, end() if there is none.
+template<SegmentedBuffer Buffer>
+auto find(Buffer& buffer, typename Buffer::value_type value) {
+    using T = std::remove_const_t<typename Buffer::value_type>;
+
+    auto first = buffer.array_one();
+    std::size_t index = kernels<T>().find(first.data(), first.size(), value);
+
+    if (index == first.size()) {
+        auto second = buffer.array_two();
+        index += kernels<T>().find(second.data(), second.size(), value);
+    }
+
+    return buffer.begin() + static_cast<std::ptrdiff_t>(index);
+}
+
+// Inner product of two buffers of the same size.
+template<SegmentedBuffer Lhs, SegmentedBuffer Rhs>
+auto dot(const Lhs& lhs, const Rhs& rhs) {
+    using T = typename Lhs::value_type;
+
+    static_assert(std::is_same_v<T, typename Rhs::value_type>, "Buffers must hold the same element type.");
+
+    if (lhs.size() != rhs.size()) {
+        throw std::invalid_argument("Buffers must have the same size.");
+    }
+
+    T result = 0;
+
+    cb::detail::ForEachRunPair(lhs, rhs, [&result](const T* a, const T* b, std::size_t n) {
+        result += kernels<T>().dot(a, b, n);
+        return true;
+    });
+
+    return result;
+}
+
+} // namespace cb::simd
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Statistics policies for CircularBuffer and CircularBufferExt. The buffer
+// calls OnPush(n, size) after storing n elements, OnPop(n) after popping n,
+// OnOverwrite(element) right before an unread element is overwritten or
+// dropped to make room, and OnReallocate(bytes) when the storage moves to a
+// new block. Loops that exist only to report are skipped unless kEnabled.
+
+// The default: every hook is empty and the policy object takes no space,
+// so a buffer without statistics compiles to exactly the same code.
+struct NoStats {
+    static constexpr bool kEnabled = false;
+
+    void OnPush(std::size_t, std::size_t) {}
+
+    void OnPop(std::size_t) {}
+
+    template<typename T>
+    void OnOverwrite(const T&) {}
+
+    void OnReallocate(std::size_t) {}
+};
+
+// Plain snapshot of the counters, safe to copy out and export.
+struct BufferStats {
+    std::size_t pushes = 0;
+    std::size_t pops = 0;
+    std::size_t overwrites = 0;
+    std::size_t reallocations = 0;
+    std::size_t bytes_moved = 0;
+    std::size_t peak_size = 0;
+};
+
+// Counts every event and, if a callback is set, reports each element that
+// is overwritten or dropped before it was read. Not synchronized: it is as
+// thread-safe as the buffer that owns it.
+template<typename T>
+class CountingStats {
+public:
+    static constexpr bool kEnabled = true;
+
+    using OverwriteCallback = std::function<void(const T&)>;
+public:
+    void OnPush(std::size_t n, std::size_t size) {
+        stats_.pushes += n;
+        stats_.peak_size = std::max(stats_.peak_size, size);
+    }
+
+    void OnPop(std::size_t n) {
+        stats_.pops += n;
+    }
+
+    void OnOverwrite(const T& element) {
+        ++stats_.overwrites;
+
+        if (on_overwrite_) {
+            on_overwrite_(element);
+        }
+    }
+
+    void OnReallocate(std::size_t bytes_moved) {
+        ++stats_.reallocations;
+        stats_.bytes_moved += bytes_moved;
+    }
+public:
+    const BufferStats& snapshot() const {
+        return stats_;
+    }
+
+    void set_overwrite_callback(OverwriteCallback callback) {
+        on_overwrite_ = std::move(callback);
+    }
+
+    void reset() {
+        stats_ = BufferStats();
+    }
+private:
+    BufferStats stats_;
+    OverwriteCallback on_overwrite_;
+};
+
+namespace cb {
+
+// One buffer's counters with its Prometheus labels, written without
+// braces: `buffer="orders",shard="3"`.
+struct StatsSample {
+    std::string labels;
+    BufferStats stats;
+};
+
+// Writes the samples in the Prometheus text exposition format, one metric
+// family per counter named `<prefix>_<counter>`.
+inline void write_prometheus(std::ostream& out, std::string_view prefix, std::span<const StatsSample> samples) {
+    struct Family {
+        const char* name;
+        const char* type;
+        const char* help;
+        std::size_t BufferStats::* field;
+    };
+
+    static constexpr Family kFamilies[] = {
+        {"pushes_total", "counter", "Elements pushed.", &BufferStats::pushes},
+        {"pops_total", "counter", "Elements popped.", &BufferStats::pops},
+        {"overwrites_total", "counter", "Unread elements overwritten or dropped.", &BufferStats::overwrites},
+        {"reallocations_total", "counter", "Storage reallocations.", &BufferStats::reallocations},
+        {"moved_bytes_total", "counter", "Bytes moved by reallocations.", &BufferStats::bytes_moved},
+        {"peak_size", "gauge", "Largest size reached.", &BufferStats::peak_size},
+    };
+
+    for (const Family& family : kFamilies) {
+        out << "# HELP " << prefix << '_' << family.name << ' ' << family.help << '\n';
+        out << "# TYPE " << prefix << '_' << family.name << ' ' << family.type << '\n';
+
+        for (const StatsSample& sample : samples) {
+            out << prefix << '_' << family.name;
+
+            if (!sample.labels.empty()) {
+                out << '{' << sample.labels << '}';
+            }
+
+            out << ' ' << sample.stats.*family.field << '\n';
+        }
+    }
+}
+
+inline void write_prometheus(std::ostream& out, std::string_view prefix, const BufferStats& stats) {
+    StatsSample sample{std::string(), stats};
+
+    write_prometheus(out, prefix, std::span<const StatsSample>(&sample, 1));
+}
+
+} // namespace cb
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Storage policies for CircularBuffer and CircularBufferExt. A policy says
+// how many slots live inside the buffer object itself and whether the
+// buffer may fall back to its allocator for more. Slots<T, Indexing> is the
+// member holding the inline slots; the buffer takes its slots from there
+// whenever they fit and never hands them to another buffer.
+
+// The default: every slot comes from the allocator and the policy member
+// takes no space.
+struct HeapStorage {
+    static constexpr std::size_t kInlineCapacity = 0;
+    static constexpr bool kSpills = true;
+
+    template<typename T, typename Indexing>
+    struct Slots {
+        static constexpr std::size_t kCount = 0;
+
+        T* data() {
+            return nullptr;
+        }
+
+        bool holds(const T*) const {
+            return false;
+        }
+    };
+};
+
+// Room for a buffer of capacity N (rounded as Indexing rounds it) inside
+// the object. With `Spills` a larger capacity comes from the allocator,
+// without it asking for one throws std::invalid_argument.
+template<std::size_t N, bool Spills>
+struct BasicInlineStorage {
+    static constexpr std::size_t kInlineCapacity = N;
+    static constexpr bool kSpills = Spills;
+
+    template<typename T, typename Indexing>
+    struct Slots {
+        static constexpr std::size_t kCount = Indexing::Slots(Indexing::Capacity(N));
+
+        T* data() {
+            return std::launder(reinterpret_cast<T*>(bytes_));
+        }
+
+        bool holds(const T* p) const {
+            return p == reinterpret_cast<const T*>(bytes_);
+        }
+
+        alignas(T) std::byte bytes_[kCount * sizeof(T)];
+    };
+};
+
+// The first N elements are kept inline, the heap is used only past them.
+template<std::size_t N>
+using InlineStorage = BasicInlineStorage<N, true>;
+
+// Exactly N inline slots and no allocation at all.
+template<std::size_t N>
+using FixedStorage = BasicInlineStorage<N, false>;
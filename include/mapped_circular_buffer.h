@@ -0,0 +1,386 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// When MappedCircularBuffer flushes the mapping to the file.
+enum class SyncPolicy {
+    // Page cache only: the data survives a crash of the process but not of
+    // the machine. Call sync() at checkpoints if needed.
+    None,
+    // Starts write-back (MS_ASYNC) after every commit without waiting.
+    Async,
+    // Waits for the slot and then the header to reach the disk (MS_SYNC) on
+    // every commit, so a power loss never exposes an uncommitted slot.
+    Sync,
+};
+
+// On-disk header. The counters are free-running: the ring holds
+// [head, tail), slot i lives at index i % capacity.
+struct MappedHeader {
+    static constexpr std::uint64_t kMagic = 0x50414d4646554243; // "CBUFFMAP"
+    static constexpr std::uint32_t kVersion = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t element_size;
+    std::uint32_t element_alignment;
+    std::uint32_t reserved;
+    std::uint64_t capacity;
+    std::uint64_t head;
+    std::uint64_t tail;
+};
+
+// Fixed-capacity ring of trivially copyable values kept in a memory-mapped
+// file: a MappedHeader followed by the slot array. A push is a store into
+// page-cache memory, and reopening the file after a restart reattaches to
+// the stored contents in O(1). Elements are read-only once pushed: an
+// in-place change could be torn by a crash.
+//
+// Commits are ordered so that a crash at any point leaves a consistent
+// ring: a push writes the slot before publishing the new tail, and a push
+// into a full ring publishes the advanced head before overwriting the
+// oldest slot. The worst case is losing the element being pushed or
+// evicted, never reading a torn one. One writer at a time. Linux only.
+template<typename T>
+class MappedCircularBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedCircularBuffer requires a trivially copyable type.");
+public:
+    using value_type             = T;
+    using reference              = const value_type&;
+    using const_reference        = const value_type&;
+    using iterator               = BufferIterator<const MappedCircularBuffer<T>>;
+    using const_iterator         = BufferIterator<const MappedCircularBuffer<T>>;
+    using reverse_iterator       = std::reverse_iterator<const_iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type        = std::ptrdiff_t;
+    using size_type              = std::size_t;
+public:
+    // Opens `path`, creating and formatting it if it does not exist yet or
+    // is empty. Any other file must have been created for the same element
+    // type and capacity; otherwise std::runtime_error is thrown and the file
+    // is left untouched.
+    MappedCircularBuffer(const std::string& path, size_type capacity, SyncPolicy policy = SyncPolicy::None)
+        : policy_(policy)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("Capacity must be positive.");
+        }
+
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "open failed");
+        }
+
+        try {
+            Attach(fd, capacity);
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+
+        close(fd);
+    }
+
+    MappedCircularBuffer(const MappedCircularBuffer&) = delete;
+    MappedCircularBuffer& operator=(const MappedCircularBuffer&) = delete;
+
+    // The moved-from buffer is left detached: empty, with zero capacity,
+    // ignoring pushes.
+    MappedCircularBuffer(MappedCircularBuffer&& other) noexcept
+        : policy_(other.policy_)
+        , mapping_(other.mapping_)
+        , mapping_size_(other.mapping_size_)
+        , header_(other.header_)
+        , data_(other.data_)
+        , capacity_(other.capacity_)
+    {
+        other.mapping_ = nullptr;
+        other.mapping_size_ = 0;
+        other.header_ = nullptr;
+        other.data_ = nullptr;
+        other.capacity_ = 0;
+    }
+
+    MappedCircularBuffer& operator=(MappedCircularBuffer&& other) noexcept {
+        MappedCircularBuffer moved(std::move(other));
+        swap(moved);
+
+        return *this;
+    }
+
+    ~MappedCircularBuffer() {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+        }
+    }
+public:
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, size());
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    void swap(MappedCircularBuffer& other) noexcept {
+        std::swap(policy_, other.policy_);
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapping_size_, other.mapping_size_);
+        std::swap(header_, other.header_);
+        std::swap(data_, other.data_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    friend void swap(MappedCircularBuffer& lhs, MappedCircularBuffer& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    size_type size() const {
+        if (header_ == nullptr) {
+            return 0;
+        }
+
+        return header_->tail - header_->head;
+    }
+
+    size_type capacity() const {
+        return capacity_;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    bool full() const {
+        return size() == capacity_;
+    }
+
+    SyncPolicy policy() const {
+        return policy_;
+    }
+
+    const_reference front() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return data_[header_->head % capacity_];
+    }
+
+    const_reference back() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return data_[(header_->tail - 1) % capacity_];
+    }
+
+    const_reference operator[](size_type n) const {
+        return data_[(header_->head + n) % capacity_];
+    }
+
+    const_reference at(size_type n) const {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return (*this)[n];
+    }
+
+    std::span<const value_type> array_one() const {
+        if (empty()) {
+            return std::span<const value_type>();
+        }
+
+        size_type slot = header_->head % capacity_;
+
+        return std::span<const value_type>(data_ + slot, std::min(size(), capacity_ - slot));
+    }
+
+    std::span<const value_type> array_two() const {
+        if (empty()) {
+            return std::span<const value_type>();
+        }
+
+        size_type slot = header_->head % capacity_;
+
+        return std::span<const value_type>(data_, size() - std::min(size(), capacity_ - slot));
+    }
+public:
+    // Overwrites the oldest element when full, like CircularBuffer.
+    void push_back(const_reference element) {
+        if (header_ == nullptr) {
+            return;
+        }
+
+        std::uint64_t tail = header_->tail;
+
+        if (tail - header_->head == capacity_) {
+            Publish(header_->head, header_->head + 1);
+        }
+
+        value_type* slot = data_ + tail % capacity_;
+
+        std::memcpy(slot, &element, sizeof(value_type));
+        Flush(slot, sizeof(value_type));
+        Publish(header_->tail, tail + 1);
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        push_back(value_type(std::forward<Args>(args)...));
+    }
+
+    void pop_front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        Publish(header_->head, header_->head + 1);
+    }
+
+    void clear() {
+        if (header_ == nullptr) {
+            return;
+        }
+
+        Publish(header_->head, header_->tail);
+    }
+
+    // Blocks until the whole mapping has reached the file, whatever the
+    // policy.
+    void sync() {
+        if (mapping_ == nullptr) {
+            return;
+        }
+
+        if (msync(mapping_, mapping_size_, MS_SYNC) == -1) {
+            throw std::system_error(errno, std::generic_category(), "msync failed");
+        }
+    }
+private:
+    static constexpr size_type DataOffset() {
+        return (sizeof(MappedHeader) + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+    }
+
+    void Attach(int fd, size_type capacity) {
+        struct stat st;
+
+        if (fstat(fd, &st) == -1) {
+            throw std::system_error(errno, std::generic_category(), "fstat failed");
+        }
+
+        MappedHeader stored{};
+
+        // Only a new, empty file is formatted. Anything else has to be a
+        // buffer already, so that an unrelated file is never overwritten;
+        // one whose formatting was interrupted is rejected as well.
+        bool formatted = st.st_size != 0;
+        size_type bytes = DataOffset() + capacity * sizeof(value_type);
+
+        if (formatted) {
+            if (static_cast<size_type>(st.st_size) < sizeof(MappedHeader)) {
+                throw std::runtime_error("The file does not hold a compatible buffer.");
+            }
+
+            if (pread(fd, &stored, sizeof(stored), 0) != static_cast<ssize_t>(sizeof(stored))) {
+                throw std::system_error(errno, std::generic_category(), "pread failed");
+            }
+
+            if (
+                stored.magic != MappedHeader::kMagic ||
+                stored.version != MappedHeader::kVersion ||
+                stored.element_size != sizeof(value_type) ||
+                stored.element_alignment != alignof(value_type) ||
+                stored.capacity != capacity ||
+                stored.tail - stored.head > capacity ||
+                static_cast<size_type>(st.st_size) < bytes
+            ) {
+                throw std::runtime_error("The file does not hold a compatible buffer.");
+            }
+        } else if (ftruncate(fd, bytes) == -1) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate failed");
+        }
+
+        void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap failed");
+        }
+
+        mapping_ = mapping;
+        mapping_size_ = bytes;
+        header_ = static_cast<MappedHeader*>(mapping);
+        data_ = reinterpret_cast<value_type*>(static_cast<char*>(mapping) + DataOffset());
+        capacity_ = capacity;
+
+        if (!formatted) {
+            header_->version = MappedHeader::kVersion;
+            header_->element_size = sizeof(value_type);
+            header_->element_alignment = alignof(value_type);
+            header_->reserved = 0;
+            header_->capacity = capacity;
+            header_->head = 0;
+            header_->tail = 0;
+            Publish(header_->magic, MappedHeader::kMagic);
+        }
+    }
+
+    // Counters are single aligned 8-byte stores, so they are never torn.
+    // The release store keeps them behind the slot writes they commit and
+    // the fence keeps the next slot write (an eviction's) behind them.
+    void Publish(std::uint64_t& field, std::uint64_t value) {
+        std::atomic_ref<std::uint64_t>(field).store(value, std::memory_order_release);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        Flush(header_, sizeof(MappedHeader));
+    }
+
+    void Flush(const void* p, size_type n) {
+        if (policy_ == SyncPolicy::None) {
+            return;
+        }
+
+        static const std::uintptr_t page = sysconf(_SC_PAGESIZE);
+        std::uintptr_t first = reinterpret_cast<std::uintptr_t>(p) & ~(page - 1);
+        std::uintptr_t last = reinterpret_cast<std::uintptr_t>(p) + n;
+
+        if (msync(reinterpret_cast<void*>(first), last - first, policy_ == SyncPolicy::Sync ? MS_SYNC : MS_ASYNC) == -1) {
+            throw std::system_error(errno, std::generic_category(), "msync failed");
+        }
+    }
+private:
+    SyncPolicy policy_;
+    void* mapping_ = nullptr;
+    size_type mapping_size_ = 0;
+    MappedHeader* header_ = nullptr;
+    value_type* data_ = nullptr;
+    size_type capacity_ = 0;
+};
@@ -0,0 +1,543 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <cerrno>
+#include <numeric>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Ring buffer whose storage is mapped twice back to back in virtual memory
+// (one memfd, two MAP_FIXED views). Any run of up to capacity() elements
+// starting anywhere in the ring is contiguous, so iterators are plain
+// pointers and every bulk transfer is a single memcpy. Only trivially
+// copyable types are supported and the storage size is rounded up to a
+// multiple of the page size. Linux only.
+//
+// The container interface follows CircularBuffer (iterators, reverse
+// iterators, every form of insert, emplace, erase, assign, resize and
+// reserve) except for the allocator: the storage is always a mapping.
+template<typename T>
+class MirroredCircularBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "MirroredCircularBuffer requires a trivially copyable type.");
+public:
+    using value_type       = T;
+    using reference        = value_type&;
+    using const_reference  = const value_type&;
+    using iterator               = value_type*;
+    using const_iterator         = const value_type*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type        = std::ptrdiff_t;
+    using size_type              = std::size_t;
+public:
+    MirroredCircularBuffer()
+        : MirroredCircularBuffer(1)
+    {}
+
+    explicit MirroredCircularBuffer(size_type capacity)
+        : capacity_(0)
+        , size_(0)
+        , head_(0)
+    {
+        size_type granularity = std::lcm<size_type>(sysconf(_SC_PAGESIZE), sizeof(value_type));
+        size_type bytes = std::max<size_type>(capacity * sizeof(value_type), 1);
+
+        bytes = (bytes + granularity - 1) / granularity * granularity;
+        data_ = MapMirrored(bytes);
+        capacity_ = bytes / sizeof(value_type);
+    }
+
+    MirroredCircularBuffer(const std::initializer_list<value_type>& init_list)
+        : MirroredCircularBuffer(init_list.size())
+    {
+        push_back_n(init_list.begin(), init_list.size());
+    }
+
+    MirroredCircularBuffer(const MirroredCircularBuffer& other)
+        : MirroredCircularBuffer(other.capacity_)
+    {
+        push_back_n(other.begin(), other.size_);
+    }
+
+    // The moved-from buffer is left empty with zero capacity and, like a
+    // CircularBuffer of capacity 0, silently ignores pushes.
+    MirroredCircularBuffer(MirroredCircularBuffer&& other) noexcept
+        : capacity_(other.capacity_)
+        , size_(other.size_)
+        , head_(other.head_)
+        , data_(other.data_)
+    {
+        other.capacity_ = 0;
+        other.size_ = 0;
+        other.head_ = 0;
+        other.data_ = nullptr;
+    }
+
+    MirroredCircularBuffer& operator=(const MirroredCircularBuffer& other) {
+        if (this != &other) {
+            MirroredCircularBuffer copy(other);
+            swap(copy);
+        }
+
+        return *this;
+    }
+
+    MirroredCircularBuffer& operator=(MirroredCircularBuffer&& other) noexcept {
+        MirroredCircularBuffer moved(std::move(other));
+        swap(moved);
+
+        return *this;
+    }
+
+    ~MirroredCircularBuffer() {
+        if (data_ != nullptr) {
+            munmap(data_, 2 * capacity_ * sizeof(value_type));
+        }
+    }
+public:
+    iterator begin() {
+        return data_ + head_;
+    }
+
+    iterator end() {
+        return data_ + head_ + size_;
+    }
+
+    const_iterator begin() const {
+        return data_ + head_;
+    }
+
+    const_iterator end() const {
+        return data_ + head_ + size_;
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const {
+        return rend();
+    }
+
+    value_type* data() {
+        return begin();
+    }
+
+    const value_type* data() const {
+        return begin();
+    }
+
+    template<typename Container>
+    bool operator==(const Container& other) const {
+        return size_ == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    template<typename Container>
+    bool operator!=(const Container& other) const {
+        return !(*this == other);
+    }
+
+    void swap(MirroredCircularBuffer& other) noexcept {
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(head_, other.head_);
+        std::swap(data_, other.data_);
+    }
+
+    friend void swap(MirroredCircularBuffer& lhs, MirroredCircularBuffer& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    size_type size() const {
+        return size_;
+    }
+
+    size_type max_size() const {
+        return std::numeric_limits<size_type>::max() / sizeof(value_type) / 2;
+    }
+
+    size_type capacity() const {
+        return capacity_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    reference front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return *begin();
+    }
+
+    const_reference front() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return *begin();
+    }
+
+    reference back() {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return *(end() - 1);
+    }
+
+    const_reference back() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return *(end() - 1);
+    }
+public:
+    // A full buffer drops whatever does not fit from the back, like
+    // CircularBuffer::insert.
+    iterator insert(const_iterator p, const_reference t) {
+        return insert(p, 1, t);
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator p, Args&&... args) {
+        return insert(p, value_type(std::forward<Args>(args)...));
+    }
+
+    iterator insert(const_iterator p, size_type n, const_reference t) {
+        value_type value = t;
+        size_type index = p - begin();
+
+        std::fill_n(begin() + index, OpenGap(index, n), value);
+
+        return begin() + index;
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    iterator insert(const_iterator p, InputIterator first, InputIterator last) {
+        size_type index = p - begin();
+
+        if constexpr (std::forward_iterator<InputIterator>) {
+            size_type n = OpenGap(index, std::distance(first, last));
+
+            std::copy_n(first, n, begin() + index);
+        } else {
+            // Single pass: one element at a time, stopping once the rest
+            // would be dropped anyway.
+            for (size_type i = index; first != last && i < capacity_; ++first, ++i) {
+                insert(begin() + i, *first);
+            }
+        }
+
+        return begin() + index;
+    }
+
+    iterator insert(const_iterator p, const std::initializer_list<value_type>& init_list) {
+        return insert(p, init_list.begin(), init_list.end());
+    }
+
+    iterator erase(const_iterator q) {
+        return erase(q, q + 1);
+    }
+
+    iterator erase(const_iterator q1, const_iterator q2) {
+        if (q1 < begin() || q2 > end() || q1 > q2) {
+            throw std::runtime_error("Cannot erase non-existing element");
+        }
+
+        size_type index = q1 - begin();
+        size_type removed = q2 - q1;
+
+        std::memmove(begin() + index, begin() + index + removed, (size_ - index - removed) * sizeof(value_type));
+        size_ -= removed;
+
+        return begin() + index;
+    }
+
+    void clear() {
+        size_ = 0;
+    }
+
+    // Maps a larger ring and copies the contents over.
+    void reserve(size_type n) {
+        if (capacity_ >= n) {
+            return;
+        }
+
+        MirroredCircularBuffer larger(n);
+        larger.push_back_n(begin(), size_);
+        swap(larger);
+    }
+
+    // New elements are value-initialized.
+    void resize(size_type n) {
+        if (n > size_) {
+            reserve(n);
+            std::fill_n(end(), n - size_, value_type());
+        }
+
+        size_ = n;
+    }
+
+    void assign(size_type n, const_reference t) {
+        value_type value = t;
+
+        clear();
+        reserve(n);
+        std::fill_n(begin(), n, value);
+        size_ = n;
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    void assign(InputIterator first, InputIterator last) {
+        clear();
+
+        if constexpr (std::forward_iterator<InputIterator>) {
+            reserve(std::distance(first, last));
+        }
+
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void assign(const std::initializer_list<value_type>& init_list) {
+        assign(init_list.begin(), init_list.end());
+    }
+public:
+    void push_back(const_reference element) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        if (size_ == capacity_) {
+            DropFront(1);
+        }
+
+        *end() = element;
+        ++size_;
+    }
+
+    void push_front(const_reference element) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        head_ = head_ == 0 ? capacity_ - 1 : head_ - 1;
+        *begin() = element;
+        size_ = std::min(size_ + 1, capacity_);
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        push_back(value_type(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        push_front(value_type(std::forward<Args>(args)...));
+    }
+
+    void pop_front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        DropFront(1);
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        --size_;
+    }
+
+    // One memcpy regardless of where the ring currently wraps.
+    void push_back_n(const value_type* items, size_type n) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        if (n > capacity_) {
+            items += n - capacity_;
+            n = capacity_;
+        }
+
+        if (size_ + n > capacity_) {
+            DropFront(size_ + n - capacity_);
+        }
+
+        std::memcpy(end(), items, n * sizeof(value_type));
+        size_ += n;
+    }
+
+    size_type pop_front_n(value_type* out, size_type n) {
+        n = std::min(n, size_);
+
+        if (n == 0) {
+            return 0;
+        }
+
+        std::memcpy(out, begin(), n * sizeof(value_type));
+        DropFront(n);
+
+        return n;
+    }
+
+    std::span<value_type> array_one() {
+        return std::span<value_type>(begin(), size_);
+    }
+
+    std::span<value_type> array_two() {
+        return std::span<value_type>();
+    }
+
+    std::span<const value_type> array_one() const {
+        return std::span<const value_type>(begin(), size_);
+    }
+
+    std::span<const value_type> array_two() const {
+        return std::span<const value_type>();
+    }
+
+    bool is_linearized() const {
+        return true;
+    }
+
+    std::span<value_type> linearize() {
+        return array_one();
+    }
+public:
+    reference operator[](size_type n) {
+        return begin()[n];
+    }
+
+    const_reference operator[](size_type n) const {
+        return begin()[n];
+    }
+
+    reference at(size_type n) {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return begin()[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return begin()[n];
+    }
+private:
+    // Shifts the elements from `index` on back by up to `n` slots, dropping
+    // what falls past the capacity. Returns the width of the gap, which is
+    // `n` trimmed to the slots left before the capacity.
+    size_type OpenGap(size_type index, size_type n) {
+        n = std::min(n, capacity_ - index);
+
+        if (n == 0) {
+            return 0;
+        }
+
+        size_type moved = std::min(size_ - index, capacity_ - index - n);
+
+        std::memmove(begin() + index + n, begin() + index, moved * sizeof(value_type));
+        size_ = index + n + moved;
+
+        return n;
+    }
+
+    void DropFront(size_type n) {
+        head_ += n;
+        size_ -= n;
+
+        if (head_ >= capacity_) {
+            head_ -= capacity_;
+        }
+    }
+
+    static value_type* MapMirrored(size_type bytes) {
+        int fd = memfd_create("circular_buffer", MFD_CLOEXEC);
+
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "memfd_create failed");
+        }
+
+        if (ftruncate(fd, bytes) == -1) {
+            int error = errno;
+            close(fd);
+
+            throw std::system_error(error, std::generic_category(), "ftruncate failed");
+        }
+
+        // Reserve both halves at once so nothing else can land in between.
+        char* base = static_cast<char*>(mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+        if (base == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+
+            throw std::system_error(error, std::generic_category(), "mmap failed");
+        }
+
+        for (char* half : {base, base + bytes}) {
+            if (mmap(half, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                int error = errno;
+                munmap(base, 2 * bytes);
+                close(fd);
+
+                throw std::system_error(error, std::generic_category(), "mmap failed");
+            }
+        }
+
+        close(fd);
+
+        return reinterpret_cast<value_type*>(base);
+    }
+private:
+    size_type capacity_;
+    size_type size_;
+    size_type head_;
+    value_type* data_;
+};
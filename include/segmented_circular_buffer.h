@@ -0,0 +1,689 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <bit>
+#include <cstring>
+
+namespace cb::detail {
+
+// About a page of elements per chunk, but never fewer than 16.
+template<typename T>
+constexpr std::size_t DefaultChunkSize() {
+    return std::max<std::size_t>(16, std::bit_floor(std::max<std::size_t>(4096 / sizeof(T), 1)));
+}
+
+} // namespace cb::detail
+
+// Unbounded ring built from fixed-size chunks of `ChunkSize` elements. The
+// chunk pointers are kept in a small CircularBufferExt; element i lives in
+// chunk (head + i) / ChunkSize, so random access costs two lookups.
+//
+// Growth appends a chunk at either end and never moves an element, so a
+// push touches at most one new chunk instead of copying the whole buffer,
+// and references to elements stay valid until that element is popped or
+// erased (insert and erase in the middle move elements, as in std::deque).
+// Chunks emptied by pops go to a free list and are reused by later pushes;
+// shrink_to_fit() returns them to the allocator.
+template<
+    typename T,
+    std::size_t ChunkSize = cb::detail::DefaultChunkSize<T>(),
+    typename Allocator = std::allocator<T>
+>
+class SegmentedCircularBuffer {
+    static_assert(std::has_single_bit(ChunkSize), "Chunk size must be a power of two.");
+    static_assert(ChunkSize * sizeof(T) >= sizeof(T*), "A chunk must be able to hold a pointer.");
+public:
+    using value_type             = typename std::allocator_traits<Allocator>::value_type;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using iterator               = BufferIterator<SegmentedCircularBuffer<T, ChunkSize, Allocator>>;
+    using const_iterator         = BufferIterator<const SegmentedCircularBuffer<T, ChunkSize, Allocator>>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using difference_type        = typename std::allocator_traits<Allocator>::difference_type;
+    using size_type              = typename std::allocator_traits<Allocator>::size_type;
+    using allocator_type         = Allocator;
+public:
+    SegmentedCircularBuffer()
+        : SegmentedCircularBuffer(Allocator())
+    {}
+
+    explicit SegmentedCircularBuffer(const Allocator& alloc)
+        : alloc_(alloc)
+        , map_(ChunkMapAllocator(alloc_))
+    {}
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    SegmentedCircularBuffer(InputIterator first, InputIterator last, const Allocator& alloc = Allocator())
+        : SegmentedCircularBuffer(alloc)
+    {
+        append(first, last);
+    }
+
+    SegmentedCircularBuffer(const std::initializer_list<value_type>& init_list, const Allocator& alloc = Allocator())
+        : SegmentedCircularBuffer(init_list.begin(), init_list.end(), alloc)
+    {}
+
+    SegmentedCircularBuffer(const SegmentedCircularBuffer& other)
+        : SegmentedCircularBuffer(other, AllocTraits::select_on_container_copy_construction(other.alloc_))
+    {}
+
+    SegmentedCircularBuffer(const SegmentedCircularBuffer& other, const Allocator& alloc)
+        : SegmentedCircularBuffer(other.begin(), other.end(), alloc)
+    {}
+
+    SegmentedCircularBuffer(SegmentedCircularBuffer&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , map_(std::move(other.map_))
+        , free_chunks_(other.free_chunks_)
+        , free_count_(other.free_count_)
+        , head_(other.head_)
+        , size_(other.size_)
+    {
+        other.free_chunks_ = nullptr;
+        other.free_count_ = 0;
+        other.head_ = 0;
+        other.size_ = 0;
+    }
+
+    SegmentedCircularBuffer& operator=(const SegmentedCircularBuffer& other) {
+        if (this != &other) {
+            clear();
+
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (alloc_ != other.alloc_) {
+                    ReleaseFreeChunks();
+                    map_ = ChunkMap(ChunkMapAllocator(other.alloc_));
+                }
+
+                alloc_ = other.alloc_;
+            }
+
+            append(other.begin(), other.end());
+        }
+
+        return *this;
+    }
+
+    SegmentedCircularBuffer& operator=(SegmentedCircularBuffer&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value
+    ) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+
+        if (AllocTraits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+            ReleaseFreeChunks();
+
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(other.alloc_);
+            }
+
+            map_ = std::move(other.map_);
+            std::swap(free_chunks_, other.free_chunks_);
+            std::swap(free_count_, other.free_count_);
+            std::swap(head_, other.head_);
+            std::swap(size_, other.size_);
+        } else {
+            append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            other.clear();
+        }
+
+        return *this;
+    }
+
+    SegmentedCircularBuffer& operator=(const std::initializer_list<value_type>& init_list) {
+        assign(init_list);
+
+        return *this;
+    }
+
+    ~SegmentedCircularBuffer() {
+        clear();
+        ReleaseFreeChunks();
+    }
+public:
+    iterator begin() {
+        return iterator(this, 0);
+    }
+
+    iterator end() {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const {
+        return rend();
+    }
+
+    template<typename Container>
+    bool operator==(const Container& other) const {
+        return size_ == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator==(const std::initializer_list<value_type>& other) const {
+        return size_ == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    template<typename Container>
+    bool operator!=(const Container& other) const {
+        return !(*this == other);
+    }
+
+    bool operator!=(const std::initializer_list<value_type>& other) const {
+        return !(*this == other);
+    }
+
+    // Swapping buffers with unequal, non-propagating allocators is undefined,
+    // as for the standard containers.
+    void swap(SegmentedCircularBuffer& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
+
+        map_.swap(other.map_);
+        std::swap(free_chunks_, other.free_chunks_);
+        std::swap(free_count_, other.free_count_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    friend void swap(SegmentedCircularBuffer& lhs, SegmentedCircularBuffer& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    allocator_type get_allocator() const {
+        return alloc_;
+    }
+
+    size_type size() const {
+        return size_;
+    }
+
+    size_type max_size() const {
+        return std::numeric_limits<size_type>::max() / sizeof(value_type);
+    }
+
+    // Elements that can be pushed at the back without allocating a chunk.
+    size_type capacity() const {
+        return (map_.size() + free_count_) * ChunkSize - head_;
+    }
+
+    static constexpr size_type chunk_size() {
+        return ChunkSize;
+    }
+
+    // Chunks in use and chunks waiting on the free list.
+    size_type chunk_count() const {
+        return map_.size();
+    }
+
+    size_type free_chunk_count() const {
+        return free_count_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    reference front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return (*this)[0];
+    }
+
+    const_reference front() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return (*this)[0];
+    }
+
+    reference back() {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return (*this)[size_ - 1];
+    }
+
+    const_reference back() const {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return (*this)[size_ - 1];
+    }
+public:
+    iterator insert(iterator p, const_reference t) {
+        return emplace(p, t);
+    }
+
+    iterator insert(iterator p, value_type&& t) {
+        return emplace(p, std::move(t));
+    }
+
+    template<typename... Args>
+    iterator emplace(iterator p, Args&&... args) {
+        size_type index = p - begin();
+        value_type value(std::forward<Args>(args)...);
+
+        InsertAt(index, 1, [&value]() -> value_type&& { return std::move(value); });
+
+        return begin() + index;
+    }
+
+    iterator insert(iterator p, size_type n, const_reference t) {
+        size_type index = p - begin();
+        value_type value(t);
+
+        InsertAt(index, n, [&value]() -> const_reference { return value; });
+
+        return begin() + index;
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    iterator insert(iterator p, InputIterator first, InputIterator last) {
+        size_type index = p - begin();
+        size_type n = std::distance(first, last);
+
+        InsertAt(index, n, [&first]() -> typename std::iterator_traits<InputIterator>::reference {
+            InputIterator current = first;
+            ++first;
+
+            return *current;
+        });
+
+        return begin() + index;
+    }
+
+    iterator insert(iterator p, const std::initializer_list<value_type>& init_list) {
+        return insert(p, init_list.begin(), init_list.end());
+    }
+
+    iterator erase(iterator q) {
+        if (empty() || q >= end()) {
+            throw std::runtime_error("Cannot erase non-existing element");
+        }
+
+        size_type index = q - begin();
+        EraseAt(index, 1);
+
+        return begin() + index;
+    }
+
+    iterator erase(iterator q1, iterator q2) {
+        size_type removed = q2 - q1;
+
+        if (empty() || size_ < removed || q1 >= end() || q2 > end()) {
+            throw std::runtime_error("Cannot erase non-existing element");
+        }
+
+        size_type index = q1 - begin();
+        EraseAt(index, removed);
+
+        return begin() + index;
+    }
+
+    // Keeps the chunks on the free list.
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < size_; ++i) {
+                AllocTraits::destroy(alloc_, std::addressof((*this)[i]));
+            }
+        }
+
+        while (!map_.empty()) {
+            ReleaseChunkBack();
+        }
+
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Puts enough chunks on the free list that `n` elements fit at the back.
+    void reserve(size_type n) {
+        while (capacity() < n) {
+            PushFreeChunk(AllocateChunk());
+        }
+    }
+
+    // Frees the chunks on the free list and trims the chunk map.
+    void shrink_to_fit() {
+        ReleaseFreeChunks();
+        map_.shrink_to_fit();
+    }
+
+    void resize(size_type n) {
+        while (size_ > n) {
+            pop_back();
+        }
+
+        while (size_ < n) {
+            emplace_back();
+        }
+    }
+
+    void assign(size_type n, const_reference t) {
+        value_type value(t);
+
+        clear();
+
+        for (size_type i = 0; i < n; ++i) {
+            emplace_back(value);
+        }
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    void assign(InputIterator first, InputIterator last) {
+        clear();
+        append(first, last);
+    }
+
+    void assign(const std::initializer_list<value_type>& init_list) {
+        assign(init_list.begin(), init_list.end());
+    }
+public:
+    void push_front(const_reference element) {
+        emplace_front(element);
+    }
+
+    void push_front(value_type&& element) {
+        emplace_front(std::move(element));
+    }
+
+    void push_back(const_reference element) {
+        emplace_back(element);
+    }
+
+    void push_back(value_type&& element) {
+        emplace_back(std::move(element));
+    }
+
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        bool new_chunk = head_ == 0;
+
+        if (new_chunk) {
+            AddChunkFront();
+            head_ = ChunkSize;
+        }
+
+        try {
+            AllocTraits::construct(alloc_, map_.front() + head_ - 1, std::forward<Args>(args)...);
+        } catch (...) {
+            if (new_chunk) {
+                ReleaseChunkFront();
+                head_ = 0;
+            }
+
+            throw;
+        }
+
+        --head_;
+        ++size_;
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        size_type tail = head_ + size_;
+        bool new_chunk = tail == map_.size() * ChunkSize;
+
+        if (new_chunk) {
+            AddChunkBack();
+        }
+
+        try {
+            AllocTraits::construct(alloc_, map_[tail / ChunkSize] + tail % ChunkSize, std::forward<Args>(args)...);
+        } catch (...) {
+            if (new_chunk) {
+                ReleaseChunkBack();
+            }
+
+            throw;
+        }
+
+        ++size_;
+    }
+
+    void pop_front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        AllocTraits::destroy(alloc_, map_.front() + head_);
+        --size_;
+
+        if (++head_ == ChunkSize) {
+            ReleaseChunkFront();
+            head_ = 0;
+        }
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        --size_;
+
+        size_type tail = head_ + size_;
+        AllocTraits::destroy(alloc_, map_[tail / ChunkSize] + tail % ChunkSize);
+
+        if (tail % ChunkSize == 0) {
+            ReleaseChunkBack();
+        }
+    }
+
+    void push_back_n(const value_type* items, size_type n) {
+        append(items, items + n);
+    }
+
+    template<
+        typename InputIterator,
+        typename = std::_RequireInputIter<InputIterator>
+    >
+    void append(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    // Moves up to `n` elements from the front into `out` and returns how
+    // many were popped.
+    size_type pop_front_n(value_type* out, size_type n) {
+        n = std::min(n, size_);
+
+        for (size_type i = 0; i < n; ++i) {
+            out[i] = std::move(front());
+            pop_front();
+        }
+
+        return n;
+    }
+public:
+    reference operator[](size_type n) {
+        size_type index = head_ + n;
+
+        return map_[index / ChunkSize][index % ChunkSize];
+    }
+
+    const_reference operator[](size_type n) const {
+        size_type index = head_ + n;
+
+        return map_[index / ChunkSize][index % ChunkSize];
+    }
+
+    reference at(size_type n) {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return (*this)[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (n >= size()) {
+            throw std::out_of_range("The index of element exceeds the size of buffer.");
+        }
+
+        return (*this)[n];
+    }
+private:
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using ChunkMapAllocator = typename AllocTraits::template rebind_alloc<value_type*>;
+    using ChunkMap = CircularBufferExt<value_type*, ChunkMapAllocator>;
+
+    value_type* AllocateChunk() {
+        return AllocTraits::allocate(alloc_, ChunkSize);
+    }
+
+    void DeallocateChunk(value_type* chunk) {
+        AllocTraits::deallocate(alloc_, chunk, ChunkSize);
+    }
+
+    // The free list is threaded through the unused chunks themselves, so
+    // releasing a chunk never allocates.
+    void PushFreeChunk(value_type* chunk) {
+        std::memcpy(static_cast<void*>(chunk), &free_chunks_, sizeof(free_chunks_));
+        free_chunks_ = chunk;
+        ++free_count_;
+    }
+
+    value_type* PopFreeChunk() {
+        value_type* chunk = free_chunks_;
+
+        std::memcpy(&free_chunks_, static_cast<const void*>(chunk), sizeof(free_chunks_));
+        --free_count_;
+
+        return chunk;
+    }
+
+    void ReleaseFreeChunks() {
+        while (free_count_ != 0) {
+            DeallocateChunk(PopFreeChunk());
+        }
+    }
+
+    // Only the map can throw here; the chunk then stays on the free list.
+    value_type* AcquireChunk() {
+        if (free_count_ == 0) {
+            PushFreeChunk(AllocateChunk());
+        }
+
+        return free_chunks_;
+    }
+
+    void AddChunkFront() {
+        map_.push_front(AcquireChunk());
+        PopFreeChunk();
+    }
+
+    void AddChunkBack() {
+        map_.push_back(AcquireChunk());
+        PopFreeChunk();
+    }
+
+    void ReleaseChunkFront() {
+        PushFreeChunk(map_.front());
+        map_.pop_front();
+    }
+
+    void ReleaseChunkBack() {
+        PushFreeChunk(map_.back());
+        map_.pop_back();
+    }
+
+    // New elements are pushed on the nearer end and rotated into place.
+    template<typename Generator>
+    void InsertAt(size_type index, size_type n, Generator generate) {
+        if (index < size_ - index) {
+            for (size_type i = 0; i < n; ++i) {
+                emplace_front(generate());
+            }
+
+            std::reverse(begin(), begin() + n);
+            std::rotate(begin(), begin() + n, begin() + n + index);
+        } else {
+            for (size_type i = 0; i < n; ++i) {
+                emplace_back(generate());
+            }
+
+            std::rotate(begin() + index, end() - n, end());
+        }
+    }
+
+    // Closes the gap of `n` elements at logical `index` from the shorter side.
+    void EraseAt(size_type index, size_type n) {
+        if (index < size_ - index - n) {
+            std::move_backward(begin(), begin() + index, begin() + index + n);
+
+            for (size_type i = 0; i < n; ++i) {
+                pop_front();
+            }
+        } else {
+            std::move(begin() + index + n, end(), begin() + index);
+
+            for (size_type i = 0; i < n; ++i) {
+                pop_back();
+            }
+        }
+    }
+private:
+    Allocator alloc_;
+    ChunkMap map_;
+    value_type* free_chunks_ = nullptr;
+    size_type free_count_ = 0;
+    size_type head_ = 0;
+    size_type size_ = 0;
+};
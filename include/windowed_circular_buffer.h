@@ -0,0 +1,348 @@
+#pragma once
+
+#include "circular_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <tuple>
+
+namespace cb::detail {
+
+// Neumaier-compensated running sum: adding and later subtracting the same
+// floating-point values does not drift the way a plain accumulator does.
+template<typename T>
+class RunningSum {
+public:
+    void Add(T x) {
+        if constexpr (std::is_floating_point_v<T>) {
+            T t = sum_ + x;
+
+            if (std::abs(sum_) >= std::abs(x)) {
+                compensation_ += (sum_ - t) + x;
+            } else {
+                compensation_ += (x - t) + sum_;
+            }
+
+            sum_ = t;
+        } else {
+            sum_ += x;
+        }
+    }
+
+    T Value() const {
+        return sum_ + compensation_;
+    }
+
+    void Clear() {
+        sum_ = T();
+        compensation_ = T();
+    }
+private:
+    T sum_ = T();
+    T compensation_ = T();
+};
+
+} // namespace cb::detail
+
+// Aggregators are policies that follow the window as it slides. The buffer
+// calls Reserve(capacity) once, Push(value) after a value enters at the back
+// and Evict(value) before the oldest value leaves at the front, so every
+// query is O(1) and every update is O(1) amortized. Custom aggregators need
+// the same members plus Clear().
+template<typename T>
+class WindowSum {
+public:
+    void Reserve(std::size_t) {}
+
+    void Push(const T& value) {
+        sum_.Add(value);
+    }
+
+    void Evict(const T& value) {
+        sum_.Add(-value);
+    }
+
+    void Clear() {
+        sum_.Clear();
+    }
+
+    T Value() const {
+        return sum_.Value();
+    }
+private:
+    cb::detail::RunningSum<T> sum_;
+};
+
+// Tracks the window mean and the sum of squared deviations from it
+// (Welford, with the matching removal update) instead of raw squares, so
+// the variance does not cancel catastrophically when the values sit far
+// from zero. Kept in double so integral windows do not overflow.
+template<typename T>
+class WindowSumOfSquares {
+public:
+    void Reserve(std::size_t) {}
+
+    void Push(const T& value) {
+        double x = static_cast<double>(value);
+        double delta = x - mean_;
+
+        ++count_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (x - mean_);
+    }
+
+    void Evict(const T& value) {
+        if (--count_ == 0) {
+            Clear();
+            return;
+        }
+
+        double x = static_cast<double>(value);
+        double delta = x - mean_;
+
+        mean_ -= delta / static_cast<double>(count_);
+        m2_ -= delta * (x - mean_);
+    }
+
+    void Clear() {
+        count_ = 0;
+        mean_ = 0.0;
+        m2_ = 0.0;
+    }
+
+    // Sum of the squares of the values in the window.
+    double Value() const {
+        return m2_ + static_cast<double>(count_) * mean_ * mean_;
+    }
+
+    // Population variance; rounding in the removal update can leave m2 a
+    // few ulps below zero for a constant window.
+    double Variance() const {
+        return count_ == 0 ? 0.0 : std::max(m2_, 0.0) / static_cast<double>(count_);
+    }
+private:
+    std::size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+// Monotonic deque: candidates are kept in window order with values
+// non-decreasing from the front (for Compare = std::less), so the front is the
+// current extremum. Equal values are all kept, which makes eviction a
+// single front comparison.
+template<typename T, typename Compare>
+class WindowExtremum {
+public:
+    void Reserve(std::size_t capacity) {
+        candidates_.reserve(capacity);
+    }
+
+    void Push(const T& value) {
+        while (!candidates_.empty() && compare_(value, candidates_.back())) {
+            candidates_.pop_back();
+        }
+
+        candidates_.push_back(value);
+    }
+
+    void Evict(const T& value) {
+        if (!candidates_.empty() && !compare_(candidates_.front(), value) && !compare_(value, candidates_.front())) {
+            candidates_.pop_front();
+        }
+    }
+
+    void Clear() {
+        candidates_.clear();
+    }
+
+    const T& Value() const {
+        return candidates_.front();
+    }
+private:
+    CircularBuffer<T> candidates_;
+    Compare compare_;
+};
+
+template<typename T>
+class WindowMin : public WindowExtremum<T, std::less<T>> {};
+
+template<typename T>
+class WindowMax : public WindowExtremum<T, std::greater<T>> {};
+
+// Fixed-capacity FIFO window over CircularBuffer that keeps the given
+// aggregators up to date on every push_back and pop_front. A push into a
+// full window evicts the oldest value first. Elements are read-only: any
+// in-place change would invalidate the aggregates.
+template<
+    typename T,
+    template<typename> class... Aggregators
+>
+class WindowedCircularBuffer {
+public:
+    using value_type       = T;
+    using reference        = const value_type&;
+    using const_reference  = const value_type&;
+    using iterator         = typename CircularBuffer<T>::const_iterator;
+    using const_iterator   = typename CircularBuffer<T>::const_iterator;
+    using difference_type  = typename CircularBuffer<T>::difference_type;
+    using size_type        = typename CircularBuffer<T>::size_type;
+public:
+    explicit WindowedCircularBuffer(size_type capacity) {
+        window_.reserve(capacity);
+        (std::get<Aggregators<T>>(aggregators_).Reserve(capacity), ...);
+    }
+public:
+    const_iterator begin() const {
+        return window_.begin();
+    }
+
+    const_iterator end() const {
+        return window_.end();
+    }
+
+    const_iterator cbegin() const {
+        return window_.cbegin();
+    }
+
+    const_iterator cend() const {
+        return window_.cend();
+    }
+
+    const_reference front() const {
+        return window_.front();
+    }
+
+    const_reference back() const {
+        return window_.back();
+    }
+
+    const_reference operator[](size_type n) const {
+        return window_[n];
+    }
+
+    const_reference at(size_type n) const {
+        return window_.at(n);
+    }
+
+    std::span<const value_type> array_one() const {
+        return window_.array_one();
+    }
+
+    std::span<const value_type> array_two() const {
+        return window_.array_two();
+    }
+
+    size_type size() const {
+        return window_.size();
+    }
+
+    size_type capacity() const {
+        return window_.capacity();
+    }
+
+    bool empty() const {
+        return window_.empty();
+    }
+
+    bool full() const {
+        return window_.size() == window_.capacity();
+    }
+public:
+    void push_back(const_reference value) {
+        emplace_back(value);
+    }
+
+    void push_back(value_type&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        if (window_.capacity() == 0) {
+            return;
+        }
+
+        if (full()) {
+            // Built first: the arguments may refer to the element evicted.
+            value_type value(std::forward<Args>(args)...);
+
+            pop_front();
+            window_.emplace_back(std::move(value));
+        } else {
+            window_.emplace_back(std::forward<Args>(args)...);
+        }
+
+        (std::get<Aggregators<T>>(aggregators_).Push(window_.back()), ...);
+    }
+
+    void pop_front() {
+        if (empty()) {
+            throw std::runtime_error("Cannot delete the element from empty buffer.");
+        }
+
+        (std::get<Aggregators<T>>(aggregators_).Evict(window_.front()), ...);
+        window_.pop_front();
+    }
+
+    void clear() {
+        window_.clear();
+        (std::get<Aggregators<T>>(aggregators_).Clear(), ...);
+    }
+public:
+    template<template<typename> class Aggregator>
+    const Aggregator<T>& aggregator() const {
+        return std::get<Aggregator<T>>(aggregators_);
+    }
+
+    size_type count() const {
+        return window_.size();
+    }
+
+    T sum() const requires (std::is_same_v<Aggregators<T>, WindowSum<T>> || ...) {
+        return aggregator<WindowSum>().Value();
+    }
+
+    double mean() const requires (std::is_same_v<Aggregators<T>, WindowSum<T>> || ...) {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return static_cast<double>(sum()) / static_cast<double>(size());
+    }
+
+    // Population variance.
+    double variance() const
+        requires (std::is_same_v<Aggregators<T>, WindowSum<T>> || ...) &&
+                 (std::is_same_v<Aggregators<T>, WindowSumOfSquares<T>> || ...)
+    {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return aggregator<WindowSumOfSquares>().Variance();
+    }
+
+    const_reference min() const requires (std::is_same_v<Aggregators<T>, WindowMin<T>> || ...) {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return aggregator<WindowMin>().Value();
+    }
+
+    const_reference max() const requires (std::is_same_v<Aggregators<T>, WindowMax<T>> || ...) {
+        if (empty()) {
+            throw std::runtime_error("Cannot access empty container.");
+        }
+
+        return aggregator<WindowMax>().Value();
+    }
+private:
+    CircularBuffer<T> window_;
+    std::tuple<Aggregators<T>...> aggregators_;
+};
+
+// Every built-in aggregator: mean, variance, min and max in O(1).
+template<typename T>
+using MovingStatistics = WindowedCircularBuffer<T, WindowSum, WindowSumOfSquares, WindowMin, WindowMax>;
@@ -0,0 +1,92 @@
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Capacity 5, content {3..7}, wrapped after two elements.
+CircularBuffer<int> MakeWrapped() {
+    CircularBuffer<int> buff(5);
+
+    for (int i = 0; i < 8; ++i) {
+        buff.push_back(i);
+    }
+
+    return buff;
+}
+
+} // namespace
+
+TEST(CBufferAlgorithmsTestSuite, ForEachTest) {
+    CircularBuffer<int> buff = MakeWrapped();
+
+    ASSERT_TRUE(!buff.is_linearized());
+
+    std::vector<int> visited;
+    cb::for_each(buff, [&visited](int& x) { visited.push_back(x); x *= 2; });
+
+    ASSERT_TRUE(visited == std::vector<int>({3, 4, 5, 6, 7}));
+    ASSERT_TRUE(buff == CircularBuffer<int>({6, 8, 10, 12, 14}));
+}
+
+TEST(CBufferAlgorithmsTestSuite, CopyFillTest) {
+    CircularBuffer<int> buff = MakeWrapped();
+    std::vector<int> out(5);
+
+    ASSERT_TRUE(cb::copy(buff, out.begin()) == out.end());
+    ASSERT_TRUE(out == std::vector<int>({3, 4, 5, 6, 7}));
+
+    cb::fill(buff, 1);
+
+    ASSERT_TRUE(buff == CircularBuffer<int>({1, 1, 1, 1, 1}));
+}
+
+TEST(CBufferAlgorithmsTestSuite, FindTest) {
+    CircularBuffer<int> buff = MakeWrapped();
+    const CircularBuffer<int>& cbuff = buff;
+
+    ASSERT_TRUE(cb::find(buff, 4) == buff.begin() + 1);
+    ASSERT_TRUE(cb::find(buff, 6) == buff.begin() + 3);
+    ASSERT_TRUE(cb::find(cbuff, 42) == cbuff.end());
+    ASSERT_TRUE(cb::find_if(buff, [](int x) { return x > 5; }) == buff.begin() + 3);
+}
+
+TEST(CBufferAlgorithmsTestSuite, AccumulateTest) {
+    CircularBuffer<int> buff = MakeWrapped();
+
+    ASSERT_TRUE(cb::accumulate(buff, 0) == 25);
+    ASSERT_TRUE(cb::accumulate(buff, 1LL, [](long long a, int b) { return a * b; }) == 2520);
+
+    CircularBuffer<std::string> words({"a", "b", "c"});
+
+    ASSERT_TRUE(cb::accumulate(words, std::string()) == "abc");
+}
+
+TEST(CBufferAlgorithmsTestSuite, EqualTest) {
+    CircularBuffer<int> wrapped = MakeWrapped();
+    CircularBuffer<int> linear({3, 4, 5, 6, 7});
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> other;
+    other.reserve(8);
+
+    // Wrapped at a different point than `wrapped`: {3, 4} | {5, 6, 7}.
+    for (int i = 5; i < 8; ++i) {
+        other.push_back(i);
+    }
+
+    other.push_front(4);
+    other.push_front(3);
+
+    ASSERT_TRUE(cb::equal(wrapped, linear));
+    ASSERT_TRUE(cb::equal(wrapped, other));
+    ASSERT_TRUE(wrapped == other);
+    ASSERT_TRUE(cb::equal(wrapped, std::vector<int>({3, 4, 5, 6, 7}).begin()));
+
+    linear.back() = 8;
+
+    ASSERT_TRUE(!cb::equal(wrapped, linear));
+    ASSERT_TRUE(wrapped != linear);
+    ASSERT_TRUE(!cb::equal(wrapped, CircularBuffer<int>({3, 4, 5})));
+}
@@ -0,0 +1,68 @@
+#include "../include/aligned_allocator.h"
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace {
+
+bool IsAligned(const void* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(AlignedAllocatorTestSuite, CircularBufferStorageTest) {
+    for (std::size_t capacity : {1, 3, 17, 1000}) {
+        CircularBuffer<char, AlignedAllocator<char>> buff;
+        buff.reserve(capacity);
+        buff.push_back('x');
+
+        ASSERT_TRUE(IsAligned(buff.array_one().data(), 64));
+    }
+
+    CircularBuffer<std::string, AlignedAllocator<std::string, 128>> strings({"a", "b", "c"});
+    strings.reserve(100);
+
+    ASSERT_TRUE(IsAligned(&strings.front(), 128));
+    ASSERT_TRUE(strings == CircularBuffer<std::string>({"a", "b", "c"}));
+}
+
+TEST(AlignedAllocatorTestSuite, HugePageTest) {
+    using Allocator = HugePageAllocator<int>;
+
+    CircularBuffer<int, Allocator, PowerOfTwoIndexing> large;
+    large.reserve(Allocator::kHugePageSize / sizeof(int));
+    large.push_back(1);
+
+    CircularBuffer<int, Allocator> small({1, 2, 3});
+
+    ASSERT_TRUE(IsAligned(large.array_one().data(), Allocator::kHugePageSize));
+    ASSERT_TRUE(IsAligned(small.array_one().data(), 64));
+}
+
+TEST(AlignedAllocatorTestSuite, SpscLayoutTest) {
+    static_assert(alignof(SpscCircularBuffer<int>) == 64);
+    static_assert(sizeof(SpscCircularBuffer<int, std::allocator<int>, PackedLayout>) <= 64);
+
+    SpscCircularBuffer<int, AlignedAllocator<int>, PackedLayout> buff(64);
+
+    std::thread producer([&buff]() {
+        for (int i = 0; i < 10000; ++i) {
+            while (!buff.try_push(i)) {}
+        }
+    });
+
+    int value = 0;
+
+    for (int i = 0; i < 10000; ++i) {
+        while (!buff.try_pop(value)) {}
+
+        ASSERT_TRUE(value == i);
+    }
+
+    producer.join();
+}
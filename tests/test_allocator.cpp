@@ -0,0 +1,232 @@
+#include "../include/aligned_allocator.h"
+#include "../include/arena_allocator.h"
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t allocations = 0;
+
+template<typename T>
+class CountingAllocator : public std::allocator<T> {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = CountingAllocator<U>;
+    };
+public:
+    CountingAllocator() = default;
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept
+    {}
+public:
+    T* allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+} // namespace
+
+static_assert(std::is_same_v<
+    CircularBufferExt<int, AlignedAllocator<int>>::iterator,
+    BufferIterator<CircularBufferExt<int, AlignedAllocator<int>>>
+>);
+static_assert(std::is_base_of_v<CircularBuffer<int, ArenaAllocator<int>>, CircularBufferExt<int, ArenaAllocator<int>>>);
+
+TEST(AllocatorTestSuite, ExtWithAllocatorTest) {
+    FixedArena arena(1 << 16);
+    CircularBufferExt<std::string, ArenaAllocator<std::string>> a(arena);
+
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(std::to_string(i));
+    }
+
+    ASSERT_TRUE(a.size() == 100 && a.front() == "0" && a.back() == "99");
+    ASSERT_TRUE(a.get_allocator().arena() == &arena);
+    ASSERT_TRUE(arena.used() > 0);
+
+    CircularBufferExt<std::string, ArenaAllocator<std::string>> b(a);
+
+    ASSERT_TRUE(b.get_allocator().arena() == &arena);
+    ASSERT_TRUE(b == a);
+}
+
+TEST(AllocatorTestSuite, PropagatingAllocatorTest) {
+    FixedArena first(1 << 12);
+    FixedArena second(1 << 12);
+
+    CircularBuffer<int, ArenaAllocator<int>> a({1, 2, 3}, first);
+    CircularBuffer<int, ArenaAllocator<int>> b({4, 5}, second);
+
+    b = a;
+
+    ASSERT_TRUE(b.get_allocator().arena() == &first);
+    ASSERT_TRUE(b == CircularBuffer<int>({1, 2, 3}));
+
+    CircularBuffer<int, ArenaAllocator<int>> c({6}, second);
+    c.swap(a);
+
+    ASSERT_TRUE(c.get_allocator().arena() == &first && c == CircularBuffer<int>({1, 2, 3}));
+    ASSERT_TRUE(a.get_allocator().arena() == &second && a == CircularBuffer<int>({6}));
+
+    a = std::move(c);
+
+    ASSERT_TRUE(a.get_allocator().arena() == &first && a == CircularBuffer<int>({1, 2, 3}));
+    ASSERT_TRUE(c.empty());
+}
+
+TEST(AllocatorTestSuite, PmrTest) {
+    std::pmr::monotonic_buffer_resource first;
+    std::pmr::monotonic_buffer_resource second;
+
+    cb::pmr::CircularBuffer<std::pmr::string> a(3, &first);
+    a.push_back("a string long enough to allocate from the resource");
+
+    // Elements are built with the buffer's resource (uses-allocator).
+    ASSERT_TRUE(a.back().get_allocator().resource() == &first);
+
+    cb::pmr::CircularBuffer<std::pmr::string> b(&second);
+    b = std::move(a);
+
+    // polymorphic_allocator does not propagate: the elements are moved into
+    // storage from `second` one by one.
+    ASSERT_TRUE(b.get_allocator().resource() == &second);
+    ASSERT_TRUE(b.back().get_allocator().resource() == &second);
+    ASSERT_TRUE(b.back() == "a string long enough to allocate from the resource");
+
+    cb::pmr::CircularBuffer<std::pmr::string> c(b);
+
+    ASSERT_TRUE(c.get_allocator().resource() == std::pmr::get_default_resource());
+
+    cb::pmr::CircularBuffer<std::pmr::string> d(std::move(b), &second);
+
+    ASSERT_TRUE(d.size() == 3 && b.empty());
+}
+
+TEST(AllocatorTestSuite, ArenaReuseTest) {
+    FixedArena arena(1 << 14);
+
+    for (int connection = 0; connection < 10000; ++connection) {
+        cb::pmr::CircularBuffer<int> buff(&arena);
+        buff.reserve(100);
+
+        for (int i = 0; i < 150; ++i) {
+            buff.push_back(i);
+        }
+
+        ASSERT_TRUE(buff.front() == 50);
+    }
+
+    // Every connection reuses the blocks freed by the previous one.
+    ASSERT_TRUE(arena.used() <= 1024);
+
+    bool thrown = false;
+
+    try {
+        CircularBuffer<int, ArenaAllocator<int>> huge(1 << 20, arena);
+    } catch (const std::bad_alloc&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+}
+
+TEST(AllocatorTestSuite, ArenaOversizedRequestTest) {
+    FixedArena arena(1 << 12);
+    // Opaque to the compiler, which would otherwise flag the constant sizes.
+    volatile std::size_t top = SIZE_MAX;
+
+    ASSERT_THROW(arena.allocate((top >> 1) + 2, 8), std::bad_alloc);
+    ASSERT_THROW(arena.allocate(top, 8), std::bad_alloc);
+    ASSERT_THROW(arena.allocate((1 << 12) + 1, 8), std::bad_alloc);
+    ASSERT_THROW(arena.allocate(64, 8192), std::bad_alloc);
+
+    void* p = arena.allocate(1 << 12, 8);
+    arena.deallocate(p, 1 << 12, 8);
+
+    ASSERT_TRUE(arena.allocate(1 << 12, 8) == p);
+}
+
+TEST(AllocatorTestSuite, SwapWithoutAllocationTest) {
+    CircularBuffer<std::string, CountingAllocator<std::string>> front({"a", "b"});
+    CircularBuffer<std::string, CountingAllocator<std::string>> back({"c", "d", "e"});
+
+    allocations = 0;
+
+    for (int tick = 0; tick < 100; ++tick) {
+        swap(front, back);
+    }
+
+    ASSERT_TRUE(allocations == 0);
+    ASSERT_TRUE(front.size() == 2 && front.front() == "a" && back.back() == "e");
+}
+
+TEST(AllocatorTestSuite, CopyAssignReuseTest) {
+    CircularBuffer<int, CountingAllocator<int>> source(4);
+    CircularBuffer<int, CountingAllocator<int>> target(4);
+    source.clear();
+
+    for (int i = 0; i < 7; ++i) {
+        source.push_back(i);
+    }
+
+    allocations = 0;
+    target = source;
+
+    ASSERT_TRUE(allocations == 0);
+    ASSERT_TRUE(target == CircularBuffer<int>({3, 4, 5, 6}));
+
+    // A larger block is kept, but the capacity still follows the source.
+    CircularBuffer<int, CountingAllocator<int>> small({1, 2});
+    CircularBuffer<int, CountingAllocator<int>> large(16);
+
+    allocations = 0;
+    large = small;
+
+    ASSERT_TRUE(allocations == 0);
+    ASSERT_TRUE(large.capacity() == 2 && large == small);
+
+    large.push_back(3);
+
+    ASSERT_TRUE(large == CircularBuffer<int>({2, 3}));
+
+    small = CircularBuffer<int, CountingAllocator<int>>(16);
+    allocations = 0;
+    small = large;
+
+    ASSERT_TRUE(allocations == 0 && small.capacity() == 2);
+
+    // shrink_to_fit gives the surplus of a reused block back.
+    CircularBufferExt<int, CountingAllocator<int>> ext(16);
+    CircularBufferExt<int, CountingAllocator<int>> three({1, 2, 3});
+
+    allocations = 0;
+    ext = three;
+    ext.shrink_to_fit();
+
+    ASSERT_TRUE(allocations == 1 && ext == three && ext.capacity() == 3);
+}
+
+TEST(AllocatorTestSuite, CopyAssignStringsReuseTest) {
+    CircularBuffer<std::string> a({"a string long enough to allocate", "b", "c"});
+    CircularBuffer<std::string> b({"x", "y"});
+    b.reserve(8);
+
+    b = a;
+
+    ASSERT_TRUE(b == a && b.capacity() == 3);
+
+    a.push_back("d");
+    b = a;
+
+    ASSERT_TRUE(b == CircularBuffer<std::string>({"b", "c", "d"}));
+}
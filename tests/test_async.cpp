@@ -0,0 +1,181 @@
+#include "../include/async_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Fire-and-forget coroutine that starts suspended; posting its handle to
+// an executor starts it.
+struct Task {
+    struct promise_type {
+        Task get_return_object() {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+void Spawn(SingleThreadExecutor& executor, Task task) {
+    executor.post(task.handle);
+}
+
+Task Produce(AsyncCircularBuffer<std::string>& channel, int n, int& pushed) {
+    for (int i = 0; i < n; ++i) {
+        if (co_await channel.push(std::to_string(i))) {
+            ++pushed;
+        }
+    }
+}
+
+Task Consume(AsyncCircularBuffer<std::string>& channel, std::vector<std::string>& out) {
+    while (std::optional<std::string> value = co_await channel.pop()) {
+        out.push_back(std::move(*value));
+    }
+}
+
+Task Forward(AsyncCircularBuffer<int>& from, AsyncCircularBuffer<int>& to) {
+    while (std::optional<int> value = co_await from.pop()) {
+        co_await to.push(*value * 2);
+    }
+
+    to.close();
+}
+
+Task Source(AsyncCircularBuffer<int>& channel, int n) {
+    for (int i = 1; i <= n; ++i) {
+        co_await channel.push(i);
+    }
+
+    channel.close();
+}
+
+Task Sink(AsyncCircularBuffer<int>& channel, long long& sum) {
+    while (std::optional<int> value = co_await channel.pop()) {
+        sum += *value;
+    }
+}
+
+} // namespace
+
+TEST(AsyncBufferTestSuite, ExecutorTest) {
+    SingleThreadExecutor executor;
+
+    ASSERT_FALSE(executor.run_one());
+    ASSERT_TRUE(executor.pending() == 0);
+}
+
+TEST(AsyncBufferTestSuite, ProducerSuspendsWhenFullTest) {
+    SingleThreadExecutor executor;
+    AsyncCircularBuffer<std::string> channel(2, executor);
+    int pushed = 0;
+
+    Spawn(executor, Produce(channel, 5, pushed));
+    executor.run();
+
+    // Two values fit, the third push is suspended.
+    ASSERT_TRUE(pushed == 2 && channel.size() == 2);
+
+    std::vector<std::string> out;
+    Spawn(executor, Consume(channel, out));
+    executor.run();
+
+    ASSERT_TRUE(pushed == 5);
+    ASSERT_TRUE(out == std::vector<std::string>({"0", "1", "2", "3", "4"}));
+    ASSERT_TRUE(channel.empty());
+
+    channel.close();
+    executor.run();
+}
+
+TEST(AsyncBufferTestSuite, ConsumerSuspendsWhenEmptyTest) {
+    SingleThreadExecutor executor;
+    AsyncCircularBuffer<std::string> channel(4, executor);
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+
+    Spawn(executor, Consume(channel, first));
+    Spawn(executor, Consume(channel, second));
+    executor.run();
+
+    ASSERT_TRUE(executor.pending() == 0);
+
+    // Values are handed directly to the waiting consumers in FIFO order.
+    int pushed = 0;
+    Spawn(executor, Produce(channel, 2, pushed));
+    executor.run();
+
+    ASSERT_TRUE(pushed == 2 && channel.empty());
+    ASSERT_TRUE(first == std::vector<std::string>({"0"}));
+    ASSERT_TRUE(second == std::vector<std::string>({"1"}));
+
+    channel.close();
+    executor.run();
+
+    ASSERT_TRUE(executor.pending() == 0);
+}
+
+TEST(AsyncBufferTestSuite, CloseTest) {
+    SingleThreadExecutor executor;
+    AsyncCircularBuffer<std::string> channel(1, executor);
+    int pushed = 0;
+
+    Spawn(executor, Produce(channel, 3, pushed));
+    executor.run();
+    channel.close();
+    executor.run();
+
+    // The suspended push failed, the later one failed at once.
+    ASSERT_TRUE(pushed == 1 && channel.closed());
+
+    std::vector<std::string> out;
+    Spawn(executor, Consume(channel, out));
+    executor.run();
+
+    ASSERT_TRUE(out == std::vector<std::string>({"0"}));
+}
+
+TEST(AsyncBufferTestSuite, ManyPipelinesTest) {
+    constexpr int kPipelines = 1000;
+    constexpr int kValues = 100;
+
+    SingleThreadExecutor executor;
+    std::vector<std::unique_ptr<AsyncCircularBuffer<int>>> channels;
+    std::vector<long long> sums(kPipelines, 0);
+
+    for (int p = 0; p < kPipelines; ++p) {
+        channels.push_back(std::make_unique<AsyncCircularBuffer<int>>(4, executor));
+        channels.push_back(std::make_unique<AsyncCircularBuffer<int>>(4, executor));
+
+        AsyncCircularBuffer<int>& input = *channels[channels.size() - 2];
+        AsyncCircularBuffer<int>& output = *channels.back();
+
+        Spawn(executor, Source(input, kValues));
+        Spawn(executor, Forward(input, output));
+        Spawn(executor, Sink(output, sums[p]));
+    }
+
+    executor.run();
+
+    for (long long sum : sums) {
+        ASSERT_TRUE(sum == kValues * (kValues + 1));
+    }
+}
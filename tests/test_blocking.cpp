@@ -0,0 +1,284 @@
+#include "../include/blocking_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(BlockingBufferTestSuite, TryPushPopTest) {
+    BlockingCircularBuffer<std::string> buff(3);
+
+    ASSERT_TRUE(buff.capacity() == 3 && buff.empty());
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(buff.try_push(std::to_string(i)));
+    }
+
+    ASSERT_FALSE(buff.try_push("overflow"));
+    ASSERT_TRUE(buff.size() == 3);
+
+    std::string value;
+
+    for (std::string expected : {"0", "1", "2"}) {
+        ASSERT_TRUE(buff.try_pop(value));
+        ASSERT_TRUE(value == expected);
+    }
+
+    ASSERT_FALSE(buff.try_pop(value));
+
+    // Nobody was waiting, so nobody was signalled.
+    ASSERT_TRUE(buff.wakeups() == 0);
+}
+
+TEST(BlockingBufferTestSuite, TimeoutTest) {
+    BlockingCircularBuffer<int> buff(1);
+    int value = 0;
+
+    ASSERT_FALSE(buff.pop_for(value, 10ms));
+    ASSERT_TRUE(buff.push_for(1, 10ms));
+    ASSERT_FALSE(buff.push_for(2, 10ms));
+    ASSERT_TRUE(buff.pop_until(value, std::chrono::steady_clock::now() + 10ms));
+    ASSERT_TRUE(value == 1);
+}
+
+TEST(BlockingBufferTestSuite, CloseTest) {
+    BlockingCircularBuffer<int> buff(4);
+    std::atomic<bool> popped = true;
+
+    std::thread consumer([&buff, &popped]() {
+        int value;
+        popped = buff.pop(value);
+    });
+
+    std::this_thread::sleep_for(10ms);
+    buff.close();
+    consumer.join();
+
+    ASSERT_FALSE(popped);
+    ASSERT_TRUE(buff.closed());
+    ASSERT_FALSE(buff.push(1));
+}
+
+TEST(BlockingBufferTestSuite, DrainAfterCloseTest) {
+    BlockingCircularBuffer<int> buff(4);
+
+    buff.push(1);
+    buff.push(2);
+    buff.close();
+
+    int out[4];
+
+    ASSERT_TRUE(buff.pop_batch(out, 4) == 2);
+    ASSERT_TRUE(out[0] == 1 && out[1] == 2);
+    ASSERT_TRUE(buff.pop_batch(out, 4) == 0);
+}
+
+TEST(BlockingBufferTestSuite, PopBatchTest) {
+    BlockingCircularBuffer<std::string> buff(8);
+
+    for (int i = 0; i < 6; ++i) {
+        buff.push(std::to_string(i));
+    }
+
+    std::vector<std::string> out;
+
+    ASSERT_TRUE(buff.pop_batch(std::back_inserter(out), 4) == 4);
+    ASSERT_TRUE(buff.pop_batch(std::back_inserter(out), 4) == 2);
+    ASSERT_TRUE(out == std::vector<std::string>({"0", "1", "2", "3", "4", "5"}));
+}
+
+TEST(BlockingBufferTestSuite, FullProducerTest) {
+    BlockingCircularBuffer<int> buff(2);
+
+    buff.push(1);
+    buff.push(2);
+
+    std::thread producer([&buff]() {
+        buff.push(3);
+    });
+
+    int value;
+
+    std::this_thread::sleep_for(10ms);
+    ASSERT_TRUE(buff.pop(value) && value == 1);
+    producer.join();
+
+    ASSERT_TRUE(buff.pop(value) && value == 2);
+    ASSERT_TRUE(buff.pop(value) && value == 3);
+}
+
+TEST(BlockingBufferTestSuite, WakeThresholdTest) {
+    BlockingCircularBuffer<int> buff(8, 4, 1h);
+    std::atomic<int> popped = 0;
+
+    std::thread consumer([&buff, &popped]() {
+        int value;
+
+        while (buff.pop(value)) {
+            ++popped;
+        }
+    });
+
+    std::this_thread::sleep_for(10ms);
+
+    for (int i = 0; i < 3; ++i) {
+        buff.push(i);
+    }
+
+    std::this_thread::sleep_for(10ms);
+    ASSERT_TRUE(popped == 0 && buff.wakeups() == 0);
+
+    buff.push(3);
+
+    while (popped != 4) {
+        std::this_thread::yield();
+    }
+
+    std::this_thread::sleep_for(10ms);
+    buff.push(4);
+    buff.push(5);
+
+    std::this_thread::sleep_for(10ms);
+    ASSERT_TRUE(popped == 4 && buff.wakeups() == 1);
+
+    buff.flush();
+
+    while (popped != 6) {
+        std::this_thread::yield();
+    }
+
+    ASSERT_TRUE(buff.wakeups() == 2);
+
+    buff.close();
+    consumer.join();
+
+    int value;
+
+    ASSERT_FALSE(buff.pop_for(value, 1ms));
+}
+
+TEST(BlockingBufferTestSuite, LingerTest) {
+    BlockingCircularBuffer<int> buff(16, 4, 5ms);
+    int value = 0;
+
+    std::thread consumer([&buff, &value]() {
+        buff.pop(value);
+    });
+
+    std::this_thread::sleep_for(10ms);
+
+    auto pushed = std::chrono::steady_clock::now();
+    buff.push(1);
+    consumer.join();
+
+    ASSERT_TRUE(value == 1 && buff.wakeups() == 0);
+    ASSERT_TRUE(std::chrono::steady_clock::now() - pushed < 1s);
+}
+
+TEST(BlockingBufferTestSuite, TimedPopBelowThresholdTest) {
+    BlockingCircularBuffer<int> buff(8, 4, 1h);
+    int value = 0;
+    bool popped = false;
+
+    std::thread consumer([&buff, &value, &popped]() {
+        popped = buff.pop_for(value, 50ms);
+    });
+
+    std::this_thread::sleep_for(10ms);
+    buff.push(7);
+    consumer.join();
+
+    ASSERT_TRUE(popped && value == 7);
+    ASSERT_TRUE(buff.wakeups() == 0);
+}
+
+TEST(BlockingBufferTestSuite, FewerWakeupsTest) {
+    constexpr int kItems = 1024;
+    std::size_t wakeups[2];
+
+    for (std::size_t threshold : {1, 16}) {
+        BlockingCircularBuffer<int> buff(64, threshold);
+
+        std::thread consumer([&buff]() {
+            int batch[64];
+
+            while (buff.pop_batch(batch, 64) != 0) {
+            }
+        });
+
+        // Pushing slower than the consumer drains lets it fall asleep
+        // between pushes.
+        for (int i = 0; i < kItems; ++i) {
+            buff.push(i);
+            std::this_thread::sleep_for(10us);
+        }
+
+        buff.flush();
+        buff.close();
+        consumer.join();
+
+        wakeups[threshold == 16] = buff.wakeups();
+    }
+
+    ASSERT_TRUE(wakeups[1] <= kItems / 16 + 2);
+    ASSERT_TRUE(wakeups[1] < wakeups[0]);
+}
+
+TEST(BlockingBufferTestSuite, StressTest) {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 20000;
+
+    for (std::size_t threshold : {1, 16}) {
+        BlockingCircularBuffer<int> buff(64, threshold);
+        std::atomic<int64_t> sum = 0;
+        std::vector<std::thread> producers;
+        std::vector<std::thread> consumers;
+
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&buff]() {
+                for (int i = 1; i <= kPerProducer; ++i) {
+                    buff.push(i);
+                }
+            });
+        }
+
+        for (int c = 0; c < kConsumers; ++c) {
+            consumers.emplace_back([&buff, &sum, c]() {
+                int batch[8];
+                int value;
+
+                if (c % 2 == 0) {
+                    while (buff.pop(value)) {
+                        sum += value;
+                    }
+                } else {
+                    while (std::size_t n = buff.pop_batch(batch, 8)) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            sum += batch[i];
+                        }
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : producers) {
+            thread.join();
+        }
+
+        buff.close();
+
+        for (auto& thread : consumers) {
+            thread.join();
+        }
+
+        ASSERT_TRUE(sum == int64_t(kProducers) * kPerProducer * (kPerProducer + 1) / 2);
+        ASSERT_TRUE(buff.empty());
+    }
+}
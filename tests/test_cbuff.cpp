@@ -1,7 +1,97 @@
 #include "../include/circular_buffer.h"
+#include "tracked.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <random>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+struct Alive {
+    static inline size_t count = 0;
+
+    int value;
+
+    Alive(int v)
+        : value(v)
+    {
+        ++count;
+    }
+
+    Alive(const Alive& other)
+        : value(other.value)
+    {
+        ++count;
+    }
+
+    Alive& operator=(const Alive& other) = default;
+
+    ~Alive() {
+        --count;
+    }
+};
+
+// Random middle inserts and erases checked against std::deque. The buffer
+// never overflows, so both must agree element for element.
+template<typename Buffer, typename Make>
+bool MatchesDequeModel(Make make) {
+    using T = typename Buffer::value_type;
+
+    Buffer buff;
+    buff.reserve(64);
+    std::deque<T> model;
+    std::mt19937 rng(42);
+
+    for (int step = 0; step < 2000; ++step) {
+        size_t index = rng() % (model.size() + 1);
+        size_t n = rng() % 4;
+
+        if (rng() % 2 == 0 && model.size() + n <= buff.capacity()) {
+            std::vector<T> values;
+
+            for (size_t i = 0; i < n; ++i) {
+                values.push_back(make(step * 4 + i));
+            }
+
+            buff.insert(buff.begin() + index, values.begin(), values.end());
+
+            // libstdc++ 12 corrupts a deque on some empty range inserts.
+            if (n != 0) {
+                model.insert(model.begin() + index, values.begin(), values.end());
+            }
+        } else if (!model.empty()) {
+            index = std::min(index, model.size() - 1);
+            n = std::min(n, model.size() - index);
+
+            buff.erase(buff.begin() + index, buff.begin() + index + n);
+            model.erase(model.begin() + index, model.begin() + index + n);
+        }
+
+        // Rotate now and then, so the contents keep crossing the wrap point.
+        if (step % 7 == 0 && !model.empty()) {
+            T front = buff.front();
+
+            buff.pop_front();
+            buff.push_back(front);
+            model.push_back(model.front());
+            model.pop_front();
+        }
+
+        if (!std::equal(buff.begin(), buff.end(), model.begin(), model.end())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
 TEST(CBufferTestSuite, EmptyTest) {
     CircularBuffer<int> buff;
     ASSERT_TRUE(buff.empty());
@@ -95,6 +185,38 @@ TEST(CBufferTestSuite, IteratorTest) {
     ASSERT_TRUE(*(buff.begin() + 3) == 3);
 }
 
+static_assert(std::random_access_iterator<CircularBuffer<int>::iterator>);
+static_assert(std::random_access_iterator<CircularBuffer<int>::const_iterator>);
+static_assert(std::random_access_iterator<CircularBuffer<int>::reverse_iterator>);
+static_assert(std::is_same_v<std::iter_reference_t<CircularBuffer<int>::const_iterator>, const int&>);
+static_assert(std::is_convertible_v<CircularBuffer<int>::iterator, CircularBuffer<int>::const_iterator>);
+static_assert(!std::is_convertible_v<CircularBuffer<int>::const_iterator, CircularBuffer<int>::iterator>);
+
+TEST(CBufferTestSuite, WrappedIteratorTest) {
+    CircularBuffer<int> buff(6);
+
+    for (int i = 0; i < 10; ++i) {
+        buff.push_back(i);
+    }
+
+    ASSERT_TRUE(!buff.is_linearized());
+    ASSERT_TRUE(buff.end() - buff.begin() == 6);
+    ASSERT_TRUE(buff.begin()[5] == 9);
+    ASSERT_TRUE(std::lower_bound(buff.begin(), buff.end(), 7) - buff.begin() == 3);
+
+    std::sort(buff.rbegin(), buff.rend());
+
+    ASSERT_TRUE(buff == CircularBuffer<int>({9, 8, 7, 6, 5, 4}));
+
+    CircularBuffer<int>::const_iterator it = buff.begin() + 2;
+    CircularBuffer<int>::iterator default_constructed;
+
+    ASSERT_TRUE(*it == 7);
+    ASSERT_TRUE(it == buff.begin() + 2 && buff.cend() > it);
+    ASSERT_TRUE(*buff.crbegin() == 4 && *(buff.crend() - 1) == 9);
+    ASSERT_TRUE(default_constructed == CircularBuffer<int>::iterator());
+}
+
 TEST(CBufferTestSuite, SwapTest) {
     CircularBuffer<int> base1({1, 2, 3});
     CircularBuffer<int> base2({3, 2, 1});
@@ -154,7 +276,7 @@ TEST(CBufferTestSuite, InsertTest) {
     ASSERT_TRUE(b == CircularBuffer<int>({1, 5, 2, 3}));
     ASSERT_TRUE(c == CircularBuffer<int>({4, 4, 4}));
     ASSERT_TRUE(d == CircularBuffer<int>({4, 4, 4, 4, 4}));
-    ASSERT_TRUE(e == CircularBuffer<int>({1, 3, 3, 3, 4}));
+    ASSERT_TRUE(e == CircularBuffer<int>({1, 3, 3, 3, 2}));
 }
 
 TEST(CBufferTestSuite, EraseTest) {
@@ -253,3 +375,428 @@ TEST(CBufferTestSuite, AtTest) {
         ASSERT_TRUE(a.at(i) == i + 1);
     }
 }
+
+TEST(CBufferTestSuite, MoveConstructorTest) {
+    CircularBuffer<std::string> a = {"hey", "have", "a", "good", "day"};
+    CircularBuffer<std::string> b(std::move(a));
+
+    ASSERT_TRUE(b == CircularBuffer<std::string>({"hey", "have", "a", "good", "day"}));
+    ASSERT_TRUE(a.empty());
+    ASSERT_TRUE(a.capacity() == 0);
+}
+
+TEST(CBufferTestSuite, MoveAssignmentTest) {
+    CircularBuffer<std::string> a = {"hey", "have", "a", "good", "day"};
+    CircularBuffer<std::string> b = {"why"};
+
+    b = std::move(a);
+
+    ASSERT_TRUE(b == CircularBuffer<std::string>({"hey", "have", "a", "good", "day"}));
+    ASSERT_TRUE(a.empty());
+
+    a = b;
+
+    ASSERT_TRUE(a == b);
+}
+
+TEST(CBufferTestSuite, PushMoveTest) {
+    CircularBuffer<Tracked> a;
+    a.reserve(3);
+    Tracked::Reset();
+
+    Tracked first(1);
+    Tracked second(2);
+    a.push_back(std::move(first));
+    a.push_front(std::move(second));
+    a.push_back(Tracked(3));
+    a.push_back(Tracked(4));
+
+    ASSERT_TRUE(Tracked::copies == 0);
+    ASSERT_TRUE(Tracked::moves > 0);
+    ASSERT_TRUE(a == CircularBuffer<Tracked>({1, 3, 4}));
+}
+
+TEST(CBufferTestSuite, EmplaceTest) {
+    CircularBuffer<Tracked> a;
+    a.reserve(4);
+    Tracked::Reset();
+
+    a.emplace_back(2);
+    a.emplace_front(1);
+    a.emplace_back(4);
+    a.emplace(a.begin() + 2, 3);
+
+    ASSERT_TRUE(Tracked::copies == 0);
+    ASSERT_TRUE(a == CircularBuffer<Tracked>({1, 2, 3, 4}));
+}
+
+TEST(CBufferTestSuite, ReserveMoveTest) {
+    CircularBuffer<Tracked> a({1, 2, 3});
+    a.push_back(4);
+    Tracked::Reset();
+
+    a.reserve(10);
+
+    ASSERT_TRUE(Tracked::copies == 0);
+    ASSERT_TRUE(a == CircularBuffer<Tracked>({2, 3, 4}));
+
+    a.push_back(5);
+
+    ASSERT_TRUE(a == CircularBuffer<Tracked>({2, 3, 4, 5}));
+}
+
+TEST(CBufferTestSuite, LiveObjectsTest) {
+    {
+        CircularBuffer<Alive> a;
+        a.reserve(1000);
+
+        ASSERT_TRUE(Alive::count == 0);
+
+        a.push_back(Alive(1));
+        a.push_back(Alive(2));
+        a.push_front(Alive(0));
+
+        ASSERT_TRUE(Alive::count == 3);
+
+        a.pop_front();
+
+        ASSERT_TRUE(Alive::count == 2);
+        ASSERT_TRUE(a.front().value == 1);
+
+        a.erase(a.begin());
+        a.insert(a.begin(), 3, Alive(5));
+
+        ASSERT_TRUE(Alive::count == 4);
+        ASSERT_TRUE(a.front().value == 5 && a.back().value == 2);
+
+        // Front-side shifts construct into and destroy slots before begin().
+        a.insert(a.begin() + 1, 2, Alive(6));
+
+        ASSERT_TRUE(Alive::count == 6);
+
+        a.erase(a.begin() + 1, a.begin() + 3);
+
+        ASSERT_TRUE(Alive::count == 4);
+        ASSERT_TRUE(a.front().value == 5 && a[1].value == 5 && a.back().value == 2);
+    }
+
+    ASSERT_TRUE(Alive::count == 0);
+
+    {
+        CircularBuffer<Alive> a(3, Alive(7));
+
+        for (int i = 0; i < 10; ++i) {
+            a.push_back(Alive(i));
+        }
+
+        ASSERT_TRUE(Alive::count == 3);
+        ASSERT_TRUE(a[0].value == 7 && a[1].value == 8 && a[2].value == 9);
+
+        a.clear();
+
+        ASSERT_TRUE(Alive::count == 0);
+    }
+}
+
+TEST(CBufferTestSuite, PowerOfTwoCapacityTest) {
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> buff1(5);
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> buff2(8);
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> buff3;
+
+    ASSERT_TRUE(buff1.capacity() == 8 && buff1.size() == 5);
+    ASSERT_TRUE(buff2.capacity() == 8 && buff2.size() == 8);
+    ASSERT_TRUE(buff3.capacity() == 0 && buff3.empty());
+
+    buff3.reserve(3);
+
+    ASSERT_TRUE(buff3.capacity() == 4);
+}
+
+TEST(CBufferTestSuite, PowerOfTwoPushTest) {
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> a({1, 2, 3, 4});
+
+    a.push_back(5);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({2, 3, 4, 5}));
+    ASSERT_TRUE(*(a.end() - 1) == 5);
+    ASSERT_TRUE(a.end() - a.begin() == 4);
+
+    a.push_front(1);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({1, 2, 3, 4}));
+
+    for (int i = 0; i < 1000; ++i) {
+        a.push_back(i);
+        a.pop_front();
+        a.push_back(i);
+    }
+
+    ASSERT_TRUE(a == CircularBuffer<int>({998, 998, 999, 999}));
+
+    std::sort(a.begin(), a.end(), std::greater<int>());
+
+    ASSERT_TRUE(a == CircularBuffer<int>({999, 999, 998, 998}));
+}
+
+TEST(CBufferTestSuite, PowerOfTwoInsertEraseTest) {
+    CircularBuffer<std::string, std::allocator<std::string>, PowerOfTwoIndexing> a = {"a", "b", "c"};
+
+    a.push_front("z");
+    a.insert(a.begin() + 2, "x");
+
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"z", "a", "x", "b"}));
+
+    a.erase(a.begin(), a.begin() + 2);
+
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"x", "b"}));
+
+    auto copy = a;
+    copy.reserve(16);
+    copy.push_back("y");
+
+    ASSERT_TRUE(copy == CircularBuffer<std::string>({"x", "b", "y"}));
+    ASSERT_TRUE(copy.capacity() == 16);
+}
+
+TEST(CBufferTestSuite, InsertEraseModelTest) {
+    auto make_int = [](int i) { return i; };
+    auto make_string = [](int i) { return std::to_string(i) + " long enough to allocate"; };
+
+    ASSERT_TRUE(MatchesDequeModel<CircularBuffer<int>>(make_int));
+    ASSERT_TRUE(MatchesDequeModel<CircularBuffer<std::string>>(make_string));
+    ASSERT_TRUE((MatchesDequeModel<CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing>>(make_int)));
+    ASSERT_TRUE((MatchesDequeModel<CircularBuffer<std::string, std::allocator<std::string>, PowerOfTwoIndexing>>(make_string)));
+    ASSERT_TRUE(MatchesDequeModel<CircularBufferExt<int>>(make_int));
+}
+
+TEST(CBufferTestSuite, InsertShorterSideTest) {
+    CircularBuffer<Tracked> a;
+    a.reserve(16);
+
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(Tracked(i));
+    }
+
+    Tracked::Reset();
+    a.insert(a.begin() + 1, Tracked(42));
+
+    // Only the first element moves, plus the inserted value itself.
+    ASSERT_TRUE(Tracked::moves + Tracked::copies <= 3);
+    ASSERT_TRUE(a[0].value == 0 && a[1].value == 42 && a[2].value == 1 && a.size() == 11);
+
+    Tracked::Reset();
+    a.erase(a.begin() + 9);
+
+    ASSERT_TRUE(Tracked::moves + Tracked::copies == 1);
+    ASSERT_TRUE(a[9].value == 9 && a.size() == 10);
+}
+
+TEST(CBufferTestSuite, ArrayOneTwoTest) {
+    CircularBuffer<int> a({1, 2, 3, 4, 5});
+
+    ASSERT_TRUE(a.array_one().size() == 5 && a.array_two().empty());
+    ASSERT_TRUE(a.is_linearized());
+
+    a.push_back(6);
+    a.push_back(7);
+
+    ASSERT_FALSE(a.is_linearized());
+    ASSERT_TRUE(a.array_one().size() + a.array_two().size() == 5);
+
+    std::vector<int> joined(a.array_one().begin(), a.array_one().end());
+    joined.insert(joined.end(), a.array_two().begin(), a.array_two().end());
+
+    ASSERT_TRUE(joined == std::vector<int>({3, 4, 5, 6, 7}));
+
+    const CircularBuffer<int>& ref = a;
+
+    ASSERT_TRUE(ref.array_one().data() == a.array_one().data());
+}
+
+TEST(CBufferTestSuite, LinearizeTest) {
+    CircularBuffer<std::string> a = {"a", "b", "c", "d", "e"};
+
+    for (std::string value : {"f", "g", "h"}) {
+        a.push_back(value);
+    }
+
+    auto span = a.linearize();
+
+    ASSERT_TRUE(a.is_linearized());
+    ASSERT_TRUE(std::vector<std::string>(span.begin(), span.end()) == std::vector<std::string>({"d", "e", "f", "g", "h"}));
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"d", "e", "f", "g", "h"}));
+
+    a.push_back("i");
+
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"e", "f", "g", "h", "i"}));
+
+    CircularBuffer<std::string, std::allocator<std::string>, PowerOfTwoIndexing> b = {"a", "b", "c", "d"};
+
+    b.push_back("e");
+    b.linearize();
+
+    ASSERT_TRUE(b.array_two().empty());
+    ASSERT_TRUE(b == CircularBuffer<std::string>({"b", "c", "d", "e"}));
+
+    {
+        CircularBuffer<Alive> c;
+        c.reserve(8);
+
+        for (int i = 0; i < 12; ++i) {
+            c.push_back(Alive(i));
+        }
+
+        c.pop_back();
+        c.pop_back();
+        c.linearize();
+
+        ASSERT_TRUE(Alive::count == 6);
+        ASSERT_TRUE(c.front().value == 4 && c.back().value == 9);
+    }
+
+    ASSERT_TRUE(Alive::count == 0);
+}
+
+TEST(CBufferTestSuite, PushBackNTest) {
+    CircularBuffer<int> a;
+    a.reserve(5);
+
+    int items[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    a.push_back_n(items, 3);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({1, 2, 3}));
+
+    a.push_back_n(items + 3, 4);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({3, 4, 5, 6, 7}));
+    ASSERT_FALSE(a.is_linearized());
+
+    a.push_back_n(items, 8);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({4, 5, 6, 7, 8}));
+
+    CircularBuffer<std::string> b({"a", "b", "c"});
+    std::string strings[] = {"d", "e"};
+
+    b.push_back_n(strings, 2);
+
+    ASSERT_TRUE(b == CircularBuffer<std::string>({"c", "d", "e"}));
+}
+
+TEST(CBufferTestSuite, PopFrontNTest) {
+    CircularBuffer<int> a({1, 2, 3, 4, 5});
+    a.push_back(6);
+    a.push_back(7);
+
+    int out[10] = {};
+
+    ASSERT_TRUE(a.pop_front_n(out, 4) == 4);
+    ASSERT_TRUE(out[0] == 3 && out[1] == 4 && out[2] == 5 && out[3] == 6);
+    ASSERT_TRUE(a == CircularBuffer<int>({7}));
+    ASSERT_TRUE(a.pop_front_n(out, 10) == 1);
+    ASSERT_TRUE(out[0] == 7 && a.empty());
+
+    {
+        CircularBuffer<Alive> b(4, Alive(1));
+        b.push_back(Alive(2));
+
+        std::vector<Alive> sink(3, Alive(0));
+
+        ASSERT_TRUE(b.pop_front_n(sink.data(), 3) == 3);
+        ASSERT_TRUE(sink[2].value == 1 && b.size() == 1 && b.front().value == 2);
+        ASSERT_TRUE(Alive::count == 4);
+    }
+
+    ASSERT_TRUE(Alive::count == 0);
+}
+
+TEST(CBufferTestSuite, AppendTest) {
+    struct Record {
+        char bytes[64];
+    };
+
+    CircularBuffer<Record> records;
+    records.reserve(4);
+
+    std::vector<Record> input(6);
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i].bytes[0] = 'a' + i;
+    }
+
+    records.append(input.begin(), input.begin() + 3);
+    records.append(input.begin() + 3, input.end());
+
+    ASSERT_TRUE(records.size() == 4);
+    ASSERT_TRUE(records.front().bytes[0] == 'c' && records.back().bytes[0] == 'f');
+
+    CircularBuffer<std::string> a({"a", "b", "c"});
+    std::list<std::string> tail = {"d", "e"};
+
+    a.append(tail.begin(), tail.end());
+
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"c", "d", "e"}));
+
+    std::istringstream stream("1 2 3 4");
+    CircularBuffer<int> b(2, 0);
+
+    b.append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+    ASSERT_TRUE(b == CircularBuffer<int>({3, 4}));
+}
+
+TEST(CBufferTestSuite, PrepareCommitTest) {
+    CircularBuffer<int, std::allocator<int>, PowerOfTwoIndexing> a({1, 2, 3, 4, 5, 6});
+
+    a.pop_front();
+    a.pop_front();
+    a.pop_front();
+
+    auto slots = a.prepare(10);
+
+    ASSERT_TRUE(slots.size() == 5);
+    ASSERT_TRUE(slots.first.size() == 2 && slots.second.size() == 3);
+
+    int next = 7;
+
+    for (int& slot : slots.first) {
+        slot = next++;
+    }
+
+    for (int& slot : slots.second) {
+        slot = next++;
+    }
+
+    a.commit(4);
+
+    ASSERT_TRUE(a == CircularBuffer<int>({4, 5, 6, 7, 8, 9, 10}));
+    ASSERT_TRUE(a.prepare(10).size() == 1);
+    ASSERT_THROW(a.commit(2), std::invalid_argument);
+
+    a.commit(1);
+
+    ASSERT_TRUE(a.prepare(1).empty());
+}
+
+TEST(CBufferTestSuite, PeekConsumeTest) {
+    CircularBuffer<std::string> a({"a", "b", "c", "d"});
+
+    a.push_back("e");
+    a.push_back("f");
+
+    auto view = a.peek(4);
+
+    ASSERT_TRUE(view.size() == 4 && view.first.size() == 3 && view.second.size() == 1);
+    ASSERT_TRUE(view.first[0] == "c" && view.first[2] == "e" && view.second[0] == "f");
+
+    a.consume(3);
+
+    ASSERT_TRUE(a == CircularBuffer<std::string>({"f"}));
+    ASSERT_TRUE(std::as_const(a).peek(10).size() == 1);
+    ASSERT_THROW(a.consume(2), std::invalid_argument);
+
+    a.consume(1);
+
+    ASSERT_TRUE(a.empty() && a.peek(1).empty());
+}
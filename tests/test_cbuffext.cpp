@@ -1,7 +1,48 @@
 #include "../include/circular_buffer.h"
+#include "tracked.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Copy-only element whose copy throws on demand; `live` catches leaks.
+struct ThrowingCopy {
+    static inline int live = 0;
+    static inline int copies_left = -1;
+
+    int value = 0;
+
+    ThrowingCopy(int v)
+        : value(v)
+    {
+        ++live;
+    }
+
+    ThrowingCopy(const ThrowingCopy& other)
+        : value(other.value)
+    {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy failed");
+        }
+
+        --copies_left;
+        ++live;
+    }
+
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+
+    ~ThrowingCopy() {
+        --live;
+    }
+};
+
+} // namespace
+
 TEST(CBufferTestExtSuite, EmptyTest) {
     CircularBufferExt<int> buff;
     ASSERT_TRUE(buff.empty());
@@ -248,3 +289,204 @@ TEST(CBufferTestExtSuite, AtTest) {
         ASSERT_TRUE(a.at(i) == i + 1);
     }
 }
+
+TEST(CBufferTestExtSuite, MoveConstructorTest) {
+    CircularBufferExt<std::string> a = {"hey", "have", "a", "good", "day"};
+    CircularBufferExt<std::string> b(std::move(a));
+
+    ASSERT_TRUE(b == CircularBufferExt<std::string>({"hey", "have", "a", "good", "day"}));
+    ASSERT_TRUE(a.empty());
+
+    a.push_back("again");
+
+    ASSERT_TRUE(a == CircularBufferExt<std::string>({"again"}));
+}
+
+TEST(CBufferTestExtSuite, MoveAssignmentTest) {
+    CircularBufferExt<std::string> a = {"hey", "have", "a", "good", "day"};
+    CircularBufferExt<std::string> b = {"why"};
+
+    b = std::move(a);
+
+    ASSERT_TRUE(b == CircularBufferExt<std::string>({"hey", "have", "a", "good", "day"}));
+    ASSERT_TRUE(a.empty());
+}
+
+TEST(CBufferTestExtSuite, PushMoveTest) {
+    CircularBufferExt<Tracked> a;
+    Tracked::Reset();
+
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(Tracked(i));
+    }
+
+    a.push_front(Tracked(-1));
+
+    ASSERT_TRUE(Tracked::copies == 0);
+    ASSERT_TRUE(a.size() == 11);
+    ASSERT_TRUE(a.front() == Tracked(-1));
+    ASSERT_TRUE(a.back() == Tracked(9));
+}
+
+TEST(CBufferTestExtSuite, EmplaceTest) {
+    CircularBufferExt<Tracked> a;
+    Tracked::Reset();
+
+    a.emplace_back(2);
+    a.emplace_front(1);
+    a.emplace_back(4);
+    a.emplace(a.begin() + 2, 3);
+
+    ASSERT_TRUE(Tracked::copies == 0);
+    ASSERT_TRUE(a == CircularBufferExt<Tracked>({1, 2, 3, 4}));
+}
+
+TEST(CBufferTestExtSuite, BulkTest) {
+    CircularBufferExt<int> a({1, 2, 3});
+    int items[] = {4, 5, 6, 7};
+
+    a.push_back_n(items, 4);
+
+    ASSERT_TRUE(a == CircularBufferExt<int>({1, 2, 3, 4, 5, 6, 7}));
+
+    std::list<int> tail = {8, 9};
+    a.append(tail.begin(), tail.end());
+
+    ASSERT_TRUE(a.size() == 9 && a.back() == 9);
+
+    int out[9] = {};
+
+    ASSERT_TRUE(a.pop_front_n(out, 9) == 9);
+    ASSERT_TRUE(out[0] == 1 && out[8] == 9);
+    ASSERT_TRUE(a.empty());
+}
+
+TEST(CBufferTestExtSuite, WrappedGrowthTest) {
+    CircularBufferExt<Tracked> a;
+
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(Tracked(i));
+        a.push_front(Tracked(-i - 1));
+    }
+
+    ASSERT_TRUE(a.size() == 20);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(a[i] == Tracked(i - 10));
+        ASSERT_TRUE(a[10 + i] == Tracked(i));
+    }
+}
+
+TEST(CBufferTestExtSuite, ThrowingGrowthTest) {
+    {
+        CircularBufferExt<ThrowingCopy> a;
+
+        for (int i = 0; i < 4; ++i) {
+            a.push_front(ThrowingCopy(i));
+        }
+
+        a.shrink_to_fit();
+        ThrowingCopy::copies_left = 2;
+
+        ASSERT_THROW(a.push_back(ThrowingCopy(4)), std::runtime_error);
+        ASSERT_TRUE(a.size() == 4 && a.capacity() == 4 && ThrowingCopy::live == 4);
+
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(a[i].value == 3 - i);
+        }
+
+        ThrowingCopy::copies_left = -1;
+        a.push_back(ThrowingCopy(4));
+
+        ASSERT_TRUE(a.size() == 5 && a.back().value == 4);
+    }
+
+    ASSERT_TRUE(ThrowingCopy::live == 0);
+}
+
+TEST(CBufferTestExtSuite, GrowthFactorTest) {
+    CircularBufferExt<int> a;
+    a.set_growth_factor(1.5);
+
+    std::vector<size_t> capacities;
+
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(i);
+
+        if (capacities.empty() || capacities.back() != a.capacity()) {
+            capacities.push_back(a.capacity());
+        }
+    }
+
+    ASSERT_TRUE(capacities == std::vector<size_t>({1, 2, 3, 4, 6, 9, 13}));
+    ASSERT_TRUE(a == CircularBufferExt<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    bool thrown = false;
+
+    try {
+        a.set_growth_factor(1.0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+}
+
+TEST(CBufferTestExtSuite, MaxCapacityTest) {
+    CircularBufferExt<int> a;
+    a.set_max_capacity(5);
+
+    for (int i = 0; i < 8; ++i) {
+        a.push_back(i);
+    }
+
+    ASSERT_TRUE(a.capacity() == 5);
+    ASSERT_TRUE(a == CircularBufferExt<int>({3, 4, 5, 6, 7}));
+
+    int items[] = {8, 9};
+    a.push_back_n(items, 2);
+
+    ASSERT_TRUE(a == CircularBufferExt<int>({5, 6, 7, 8, 9}));
+
+    CircularBufferExt<int> b(a);
+    b.push_back(10);
+
+    ASSERT_TRUE(b.capacity() == 5 && b.front() == 6);
+}
+
+TEST(CBufferTestExtSuite, ShrinkToFitTest) {
+    CircularBufferExt<std::string> a;
+
+    for (int i = 0; i < 9; ++i) {
+        a.push_back(std::to_string(i));
+    }
+
+    a.pop_front();
+    a.pop_front();
+    a.push_back("9");
+    a.shrink_to_fit();
+
+    ASSERT_TRUE(a.capacity() == 8);
+    ASSERT_TRUE(a.front() == "2" && a.back() == "9");
+
+    a.push_back("10");
+
+    ASSERT_TRUE(a.size() == 9 && a.capacity() == 16);
+}
+
+TEST(CBufferTestExtSuite, PrepareGrowsTest) {
+    CircularBufferExt<char> a;
+
+    auto slots = a.prepare(100);
+
+    ASSERT_TRUE(slots.size() == 100 && slots.second.empty());
+
+    std::fill(slots.first.begin(), slots.first.end(), 'x');
+    a.commit(60);
+
+    ASSERT_TRUE(a.size() == 60 && a.back() == 'x');
+
+    a.set_max_capacity(a.capacity());
+
+    ASSERT_TRUE(a.prepare(1000).size() == a.capacity() - 60);
+}
@@ -0,0 +1,165 @@
+#include "../include/mapped_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Event {
+    int64_t timestamp;
+    int32_t code;
+    char tag[4];
+};
+
+// Fresh file name per test, removed on exit.
+class TempPath {
+public:
+    explicit TempPath(const std::string& name)
+        : path_(::testing::TempDir() + "cbuffer_" + name + "_" + std::to_string(getpid()))
+    {
+        std::remove(path_.c_str());
+    }
+
+    ~TempPath() {
+        std::remove(path_.c_str());
+    }
+
+    const std::string& str() const {
+        return path_;
+    }
+private:
+    std::string path_;
+};
+
+} // namespace
+
+TEST(MappedBufferTestSuite, PushPopTest) {
+    TempPath path("push_pop");
+    MappedCircularBuffer<int> buff(path.str(), 4);
+
+    ASSERT_TRUE(buff.empty() && buff.capacity() == 4);
+
+    for (int i = 0; i < 6; ++i) {
+        buff.push_back(i);
+    }
+
+    ASSERT_TRUE(buff.full() && buff.front() == 2 && buff.back() == 5);
+    ASSERT_TRUE(std::vector<int>(buff.begin(), buff.end()) == std::vector<int>({2, 3, 4, 5}));
+    ASSERT_TRUE(buff.array_one().size() == 2 && buff.array_two().size() == 2);
+    ASSERT_TRUE(buff == CircularBuffer<int>({2, 3, 4, 5}));
+
+    buff.pop_front();
+
+    ASSERT_TRUE(buff.size() == 3 && buff[0] == 3 && buff.at(2) == 5);
+
+    buff.clear();
+
+    ASSERT_TRUE(buff.empty());
+}
+
+TEST(MappedBufferTestSuite, ReattachTest) {
+    TempPath path("reattach");
+
+    {
+        MappedCircularBuffer<Event> buff(path.str(), 8, SyncPolicy::Sync);
+
+        for (int i = 0; i < 11; ++i) {
+            buff.push_back(Event{i * 100, i, {'e', 'v', 't', '\0'}});
+        }
+    }
+
+    MappedCircularBuffer<Event> buff(path.str(), 8);
+
+    ASSERT_TRUE(buff.size() == 8);
+    ASSERT_TRUE(buff.front().code == 3 && buff.back().timestamp == 1000);
+    ASSERT_TRUE(std::string(buff[4].tag) == "evt");
+
+    buff.push_back(Event{1100, 11, {}});
+    buff.sync();
+
+    ASSERT_TRUE(buff.front().code == 4 && buff.back().code == 11);
+}
+
+TEST(MappedBufferTestSuite, IncompatibleFileTest) {
+    TempPath path("incompatible");
+
+    {
+        MappedCircularBuffer<int> buff(path.str(), 8, SyncPolicy::Async);
+        buff.push_back(1);
+    }
+
+    bool thrown = false;
+
+    try {
+        MappedCircularBuffer<int> buff(path.str(), 16);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+
+    thrown = false;
+
+    try {
+        MappedCircularBuffer<Event> buff(path.str(), 8);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+}
+
+TEST(MappedBufferTestSuite, ForeignFileTest) {
+    TempPath path("foreign");
+    const std::string text = "hello world, precious data";
+
+    {
+        std::FILE* file = std::fopen(path.str().c_str(), "w");
+        std::fputs(text.c_str(), file);
+        std::fclose(file);
+    }
+
+    ASSERT_THROW((MappedCircularBuffer<int>(path.str(), 4)), std::runtime_error);
+
+    char contents[64] = {};
+    std::FILE* file = std::fopen(path.str().c_str(), "r");
+    std::size_t read = std::fread(contents, 1, sizeof(contents), file);
+    std::fclose(file);
+
+    ASSERT_TRUE(std::string(contents, read) == text);
+
+    // An empty file is formatted like a new one.
+    std::fclose(std::fopen(path.str().c_str(), "w"));
+
+    MappedCircularBuffer<int> buff(path.str(), 4);
+    buff.push_back(1);
+
+    ASSERT_TRUE(buff.size() == 1);
+}
+
+TEST(MappedBufferTestSuite, MoveTest) {
+    TempPath path("move");
+    MappedCircularBuffer<int> a(path.str(), 4);
+    a.push_back(7);
+
+    MappedCircularBuffer<int> b(std::move(a));
+
+    ASSERT_TRUE(b.size() == 1 && b.front() == 7);
+    ASSERT_TRUE(a.empty() && a.size() == 0 && a.capacity() == 0);
+    ASSERT_TRUE(a.begin() == a.end() && a.array_one().empty() && a.array_two().empty());
+    ASSERT_THROW(a.front(), std::runtime_error);
+    ASSERT_THROW(a.pop_front(), std::runtime_error);
+
+    a.push_back(8);
+    a.clear();
+    a.sync();
+
+    ASSERT_TRUE(a.empty());
+
+    a = std::move(b);
+
+    ASSERT_TRUE(a.size() == 1 && a.front() == 7 && b.empty());
+}
@@ -0,0 +1,135 @@
+#include "../include/mirrored_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+TEST(MirroredBufferTestSuite, CapacityTest) {
+    MirroredCircularBuffer<int> buff(10);
+    size_t page = sysconf(_SC_PAGESIZE);
+
+    ASSERT_TRUE(buff.capacity() * sizeof(int) % page == 0);
+    ASSERT_TRUE(buff.capacity() >= 10);
+    ASSERT_TRUE(buff.empty());
+
+    struct Odd {
+        char bytes[24];
+    };
+
+    MirroredCircularBuffer<Odd> odd(1);
+
+    ASSERT_TRUE(odd.capacity() * sizeof(Odd) % page == 0);
+}
+
+TEST(MirroredBufferTestSuite, WrapTest) {
+    MirroredCircularBuffer<int> buff(1);
+    int capacity = buff.capacity();
+
+    for (int i = 0; i < capacity + capacity / 2; ++i) {
+        buff.push_back(i);
+    }
+
+    ASSERT_TRUE(buff.size() == size_t(capacity));
+    ASSERT_TRUE(buff.front() == capacity / 2);
+    ASSERT_TRUE(buff.back() == capacity + capacity / 2 - 1);
+    ASSERT_TRUE(buff.end() - buff.begin() == capacity);
+    ASSERT_TRUE(buff.array_two().empty());
+
+    for (int i = 0; i < capacity; ++i) {
+        ASSERT_TRUE(buff[i] == capacity / 2 + i);
+    }
+
+    std::vector<int> out(capacity);
+
+    ASSERT_TRUE(buff.pop_front_n(out.data(), capacity) == size_t(capacity));
+    ASSERT_TRUE(out.front() == capacity / 2 && out.back() == capacity + capacity / 2 - 1);
+    ASSERT_TRUE(buff.empty());
+}
+
+TEST(MirroredBufferTestSuite, ContainerTest) {
+    MirroredCircularBuffer<int> a = {1, 2, 3};
+
+    a.push_front(0);
+    a.insert(a.begin() + 2, 7);
+
+    ASSERT_TRUE(a == std::vector<int>({0, 1, 7, 2, 3}));
+
+    a.erase(a.begin() + 1, a.begin() + 3);
+    a.pop_back();
+
+    ASSERT_TRUE(a == std::vector<int>({0, 2}));
+
+    MirroredCircularBuffer<int> b = a;
+    b.push_back(5);
+
+    MirroredCircularBuffer<int> c = std::move(b);
+
+    ASSERT_TRUE(a == std::vector<int>({0, 2}));
+    ASSERT_TRUE(c == std::vector<int>({0, 2, 5}));
+
+    std::sort(c.begin(), c.end(), std::greater<int>());
+
+    ASSERT_TRUE(c == std::vector<int>({5, 2, 0}));
+}
+
+TEST(MirroredBufferTestSuite, MovedFromTest) {
+    MirroredCircularBuffer<int> a = {1, 2, 3};
+    MirroredCircularBuffer<int> b = std::move(a);
+    int items[] = {4, 5};
+    int out[2];
+
+    a.push_back(1);
+    a.push_front(2);
+    a.push_back_n(items, 2);
+
+    ASSERT_TRUE(a.empty() && a.capacity() == 0);
+    ASSERT_TRUE(a.pop_front_n(out, 2) == 0);
+    ASSERT_THROW(a.pop_front(), std::runtime_error);
+
+    a = b;
+    a.push_back(4);
+
+    ASSERT_TRUE(a == std::vector<int>({1, 2, 3, 4}));
+    ASSERT_TRUE(b == std::vector<int>({1, 2, 3}));
+}
+
+TEST(MirroredBufferTestSuite, InterfaceTest) {
+    MirroredCircularBuffer<int> a = {1, 2, 3};
+    std::size_t capacity = a.capacity();
+
+    a.insert(a.begin() + 1, 2, 9);
+    a.insert(a.end(), {7, 8});
+    a.emplace(a.begin(), 0);
+
+    ASSERT_TRUE(a == std::vector<int>({0, 1, 9, 9, 2, 3, 7, 8}));
+    ASSERT_TRUE(std::vector<int>(a.rbegin(), a.rend()) == std::vector<int>({8, 7, 3, 2, 9, 9, 1, 0}));
+    ASSERT_TRUE(*a.crbegin() == 8 && *(a.crend() - 1) == 0);
+
+    std::istringstream input("4 5 6");
+    a.insert(a.begin() + 2, std::istream_iterator<int>(input), std::istream_iterator<int>());
+
+    ASSERT_TRUE(a == std::vector<int>({0, 1, 4, 5, 6, 9, 9, 2, 3, 7, 8}));
+
+    // A full buffer drops what does not fit from the back.
+    a.assign(capacity, 1);
+    a.insert(a.begin() + 1, 3, 2);
+
+    ASSERT_TRUE(a.size() == capacity && a[0] == 1 && a[3] == 2 && a[4] == 1);
+
+    std::vector<int> source(capacity + 5, 5);
+    a.insert(a.end() - 1, source.begin(), source.end());
+
+    ASSERT_TRUE(a.size() == capacity && a.back() == 5 && a[capacity - 2] == 1);
+
+    a.assign({4, 5, 6});
+    a.resize(5);
+
+    ASSERT_TRUE(a == std::vector<int>({4, 5, 6, 0, 0}));
+
+    a.resize(2);
+    a.reserve(capacity * 3);
+
+    ASSERT_TRUE(a.capacity() >= capacity * 3 && a == std::vector<int>({4, 5}));
+}
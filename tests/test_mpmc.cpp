@@ -0,0 +1,97 @@
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MpmcBufferTestSuite, CapacityTest) {
+    MpmcCircularBuffer<int> buff1(5);
+    MpmcCircularBuffer<int> buff2(1);
+
+    ASSERT_TRUE(buff1.capacity() == 8);
+    ASSERT_TRUE(buff2.capacity() == 2);
+    ASSERT_TRUE(buff1.empty());
+    ASSERT_TRUE(buff1.policy() == OverflowPolicy::Reject);
+}
+
+TEST(MpmcBufferTestSuite, RejectTest) {
+    MpmcCircularBuffer<std::string> buff(4);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(buff.try_push(std::to_string(i)));
+    }
+
+    ASSERT_FALSE(buff.try_push("overflow"));
+    ASSERT_TRUE(buff.size() == 4);
+
+    std::string value;
+
+    for (std::string expected : {"0", "1", "2", "3"}) {
+        ASSERT_TRUE(buff.try_pop(value));
+        ASSERT_TRUE(value == expected);
+    }
+
+    ASSERT_FALSE(buff.try_pop(value));
+}
+
+TEST(MpmcBufferTestSuite, OverwriteTest) {
+    MpmcCircularBuffer<std::string> buff(4, OverflowPolicy::Overwrite);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(buff.try_push(std::to_string(i)));
+    }
+
+    ASSERT_TRUE(buff.size() == 4);
+
+    std::string value;
+
+    for (std::string expected : {"6", "7", "8", "9"}) {
+        buff.pop_wait(value);
+        ASSERT_TRUE(value == expected);
+    }
+
+    ASSERT_TRUE(buff.empty());
+}
+
+TEST(MpmcBufferTestSuite, StressTest) {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 50000;
+
+    MpmcCircularBuffer<int> buff(64);
+    std::atomic<int64_t> sum = 0;
+    std::atomic<int> consumed = 0;
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&buff]() {
+            for (int i = 1; i <= kPerProducer; ++i) {
+                buff.push_wait(i);
+            }
+        });
+    }
+
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&buff, &sum, &consumed]() {
+            int value;
+
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (buff.try_pop(value)) {
+                    sum += value;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_TRUE(sum == int64_t(kProducers) * kPerProducer * (kPerProducer + 1) / 2);
+    ASSERT_TRUE(buff.empty());
+}
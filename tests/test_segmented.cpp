@@ -0,0 +1,215 @@
+#include "../include/segmented_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t chunk_allocations = 0;
+
+template<typename T>
+class ChunkCountingAllocator : public std::allocator<T> {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = ChunkCountingAllocator<U>;
+    };
+public:
+    ChunkCountingAllocator() = default;
+
+    template<typename U>
+    ChunkCountingAllocator(const ChunkCountingAllocator<U>&) noexcept
+    {}
+public:
+    T* allocate(std::size_t n) {
+        if constexpr (!std::is_pointer_v<T>) {
+            ++chunk_allocations;
+        }
+
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+} // namespace
+
+static_assert(std::random_access_iterator<SegmentedCircularBuffer<int>::iterator>);
+static_assert(std::random_access_iterator<SegmentedCircularBuffer<int>::const_iterator>);
+
+TEST(SegmentedTestSuite, PushPopTest) {
+    SegmentedCircularBuffer<int, 4> buffer;
+
+    for (int i = 0; i < 10; ++i) {
+        buffer.push_back(i);
+    }
+
+    for (int i = 1; i <= 5; ++i) {
+        buffer.push_front(-i);
+    }
+
+    ASSERT_TRUE(buffer.size() == 15);
+    ASSERT_TRUE(buffer.front() == -5 && buffer.back() == 9);
+    ASSERT_TRUE(buffer.at(5) == 0 && buffer[14] == 9);
+    ASSERT_THROW(buffer.at(15), std::out_of_range);
+
+    buffer.pop_front();
+    buffer.pop_back();
+
+    ASSERT_TRUE(buffer == std::vector<int>({-4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8}));
+
+    while (!buffer.empty()) {
+        buffer.pop_back();
+    }
+
+    ASSERT_TRUE(buffer.chunk_count() == 0);
+    ASSERT_THROW(buffer.pop_front(), std::runtime_error);
+    ASSERT_THROW(buffer.front(), std::runtime_error);
+}
+
+TEST(SegmentedTestSuite, DequeModelTest) {
+    SegmentedCircularBuffer<std::string, 8> buffer;
+    std::deque<std::string> model;
+    std::mt19937 gen(42);
+
+    for (int step = 0; step < 20000; ++step) {
+        std::string value = std::to_string(step);
+
+        switch (gen() % 6) {
+        case 0:
+        case 1:
+            buffer.push_back(value);
+            model.push_back(value);
+            break;
+        case 2:
+            buffer.push_front(value);
+            model.push_front(value);
+            break;
+        case 3:
+            if (!model.empty()) {
+                buffer.pop_front();
+                model.pop_front();
+            }
+            break;
+        case 4:
+            if (!model.empty()) {
+                buffer.pop_back();
+                model.pop_back();
+            }
+            break;
+        case 5: {
+            std::size_t index = gen() % (model.size() + 1);
+            buffer.insert(buffer.begin() + index, value);
+            model.insert(model.begin() + index, value);
+
+            if (!model.empty()) {
+                std::size_t erased = gen() % model.size();
+                buffer.erase(buffer.begin() + erased);
+                model.erase(model.begin() + erased);
+            }
+            break;
+        }
+        }
+
+        ASSERT_TRUE(buffer.size() == model.size());
+    }
+
+    ASSERT_TRUE(buffer == model);
+}
+
+TEST(SegmentedTestSuite, StableReferencesTest) {
+    SegmentedCircularBuffer<int, 16> buffer;
+    buffer.push_back(7);
+
+    int* first = &buffer.front();
+
+    for (int i = 0; i < 10000; ++i) {
+        buffer.push_back(i);
+        buffer.push_front(-i);
+    }
+
+    ASSERT_TRUE(&buffer[10000] == first && *first == 7);
+}
+
+TEST(SegmentedTestSuite, ChunkReuseTest) {
+    SegmentedCircularBuffer<int, 16, ChunkCountingAllocator<int>> buffer;
+    buffer.reserve(64);
+
+    ASSERT_TRUE(buffer.capacity() >= 64 && buffer.free_chunk_count() == 4);
+
+    chunk_allocations = 0;
+
+    for (int i = 0; i < 100000; ++i) {
+        buffer.push_back(i);
+
+        if (buffer.size() > 40) {
+            buffer.pop_front();
+        }
+    }
+
+    ASSERT_TRUE(chunk_allocations == 0);
+
+    buffer.clear();
+    buffer.shrink_to_fit();
+
+    ASSERT_TRUE(buffer.chunk_count() == 0 && buffer.free_chunk_count() == 0);
+}
+
+TEST(SegmentedTestSuite, InsertEraseTest) {
+    SegmentedCircularBuffer<int, 4> buffer({1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    buffer.insert(buffer.begin() + 1, {10, 11, 12});
+    ASSERT_TRUE(buffer == std::vector<int>({1, 10, 11, 12, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    buffer.insert(buffer.end() - 1, 2, 0);
+    ASSERT_TRUE(buffer == std::vector<int>({1, 10, 11, 12, 2, 3, 4, 5, 6, 7, 8, 0, 0, 9}));
+
+    buffer.erase(buffer.begin(), buffer.begin() + 4);
+    buffer.erase(buffer.end() - 3, buffer.end() - 1);
+    ASSERT_TRUE(buffer == std::vector<int>({2, 3, 4, 5, 6, 7, 8, 9}));
+
+    ASSERT_THROW(buffer.erase(buffer.end()), std::runtime_error);
+}
+
+TEST(SegmentedTestSuite, AlgorithmsTest) {
+    SegmentedCircularBuffer<int, 8> buffer;
+
+    for (int i = 0; i < 100; ++i) {
+        buffer.push_front(i * 37 % 101);
+    }
+
+    std::sort(buffer.begin(), buffer.end());
+
+    ASSERT_TRUE(std::is_sorted(buffer.cbegin(), buffer.cend()));
+    ASSERT_TRUE(std::binary_search(buffer.begin(), buffer.end(), 37));
+    ASSERT_TRUE(*buffer.rbegin() == buffer.back());
+}
+
+TEST(SegmentedTestSuite, CopyMoveTest) {
+    SegmentedCircularBuffer<std::string, 4> buffer({"a", "b", "c", "d", "e"});
+    buffer.push_front("z");
+
+    SegmentedCircularBuffer<std::string, 4> copy(buffer);
+    ASSERT_TRUE(copy == buffer);
+
+    SegmentedCircularBuffer<std::string, 4> moved(std::move(copy));
+    ASSERT_TRUE(moved == buffer && copy.empty());
+
+    copy = moved;
+    moved = {"x"};
+    ASSERT_TRUE(copy == buffer && moved == std::vector<std::string>({"x"}));
+
+    swap(copy, moved);
+    ASSERT_TRUE(moved == buffer && copy.size() == 1);
+
+    copy = std::move(moved);
+    ASSERT_TRUE(copy == buffer);
+
+    copy.resize(2);
+    ASSERT_TRUE(copy == std::vector<std::string>({"z", "a"}));
+}
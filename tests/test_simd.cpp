@@ -0,0 +1,146 @@
+#include "../include/circular_buffer.h"
+#include "../include/circular_buffer_simd.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+const cb::simd::Isa kAllIsas[] = {
+    cb::simd::Isa::Scalar,
+    cb::simd::Isa::Sse42,
+    cb::simd::Isa::Avx2,
+    cb::simd::Isa::Neon,
+};
+
+// Small integral values, so floating-point sums are exact in any order.
+template<typename T>
+std::vector<T> MakeValues(size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(-100, 100);
+    std::vector<T> values(n);
+
+    for (auto& value : values) {
+        value = static_cast<T>(dist(gen));
+    }
+
+    return values;
+}
+
+// Every supported kernel set must agree with the scalar one for all lengths
+// around the vector width and for unaligned starts.
+template<typename T>
+void CheckKernels() {
+    const auto& scalar = cb::simd::kernels<T>(cb::simd::Isa::Scalar);
+    std::vector<T> a = MakeValues<T>(80, 1);
+    std::vector<T> b = MakeValues<T>(80, 2);
+
+    for (cb::simd::Isa isa : kAllIsas) {
+        if (!cb::simd::is_supported(isa)) {
+            continue;
+        }
+
+        const auto& k = cb::simd::kernels<T>(isa);
+
+        for (size_t offset = 0; offset < 3; ++offset) {
+            for (size_t n = 0; n + offset <= 67; ++n) {
+                const T* p = a.data() + offset;
+                const T* q = b.data() + offset;
+
+                ASSERT_TRUE(k.sum(p, n) == scalar.sum(p, n));
+                ASSERT_TRUE(k.dot(p, q, n) == scalar.dot(p, q, n));
+                ASSERT_TRUE(k.count_greater(p, n, T(10)) == scalar.count_greater(p, n, T(10)));
+                ASSERT_TRUE(k.find(p, n, T(7)) == scalar.find(p, n, T(7)));
+
+                if (n != 0) {
+                    ASSERT_TRUE(k.min(p, n) == scalar.min(p, n));
+                    ASSERT_TRUE(k.max(p, n) == scalar.max(p, n));
+                    ASSERT_TRUE(k.find(p, n, p[n - 1]) == scalar.find(p, n, p[n - 1]));
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+CircularBuffer<T> MakeWrapped(const std::vector<T>& values) {
+    CircularBuffer<T> buff;
+    buff.reserve(values.size());
+
+    for (size_t i = 0; i < values.size() / 3; ++i) {
+        buff.push_back(T(0));
+    }
+
+    for (const T& value : values) {
+        buff.push_back(value);
+    }
+
+    return buff;
+}
+
+} // namespace
+
+TEST(CBufferSimdTestSuite, FloatKernelsTest) {
+    CheckKernels<float>();
+}
+
+TEST(CBufferSimdTestSuite, DoubleKernelsTest) {
+    CheckKernels<double>();
+}
+
+TEST(CBufferSimdTestSuite, Int64KernelsTest) {
+    CheckKernels<std::int64_t>();
+}
+
+TEST(CBufferSimdTestSuite, Int64DotTest) {
+    // Exercises the high halves of the emulated 64-bit multiply.
+    std::vector<std::int64_t> a = {1LL << 40, -(3LL << 33), 123456789012LL, -5, 7, 1LL << 31, -(1LL << 35), 99};
+    std::vector<std::int64_t> b = {3, 5, -7, 1LL << 40, -(1LL << 50), 1LL << 31, 11, -13};
+
+    for (cb::simd::Isa isa : kAllIsas) {
+        if (cb::simd::is_supported(isa)) {
+            ASSERT_TRUE(cb::simd::kernels<std::int64_t>(isa).dot(a.data(), b.data(), a.size()) ==
+                        cb::simd::kernels<std::int64_t>(cb::simd::Isa::Scalar).dot(a.data(), b.data(), a.size()));
+        }
+    }
+}
+
+TEST(CBufferSimdTestSuite, WrappedBufferTest) {
+    std::vector<double> values = MakeValues<double>(100, 3);
+    CircularBuffer<double> buff = MakeWrapped(values);
+
+    ASSERT_TRUE(!buff.is_linearized());
+    ASSERT_TRUE(cb::simd::sum(buff) == std::accumulate(values.begin(), values.end(), 0.0));
+    ASSERT_TRUE(cb::simd::mean(buff) == std::accumulate(values.begin(), values.end(), 0.0) / 100);
+    ASSERT_TRUE(cb::simd::min(buff) == *std::min_element(values.begin(), values.end()));
+    ASSERT_TRUE(cb::simd::max(buff) == *std::max_element(values.begin(), values.end()));
+    ASSERT_TRUE(cb::simd::count_greater(buff, 50.0) == static_cast<size_t>(std::count_if(values.begin(), values.end(), [](double x) { return x > 50.0; })));
+    ASSERT_TRUE(cb::simd::find(buff, values[90]) - buff.begin() == std::find(values.begin(), values.end(), values[90]) - values.begin());
+    ASSERT_TRUE(cb::simd::find(buff, 1000.0) == buff.end());
+
+    CircularBuffer<double> linear(values.begin(), values.end());
+
+    ASSERT_TRUE(cb::simd::dot(buff, linear) == std::inner_product(values.begin(), values.end(), values.begin(), 0.0));
+}
+
+TEST(CBufferSimdTestSuite, EmptyBufferTest) {
+    CircularBuffer<float> buff;
+    bool thrown = false;
+
+    ASSERT_TRUE(cb::simd::sum(buff) == 0.0f);
+    ASSERT_TRUE(cb::simd::count_greater(buff, 0.0f) == 0);
+    ASSERT_TRUE(cb::simd::find(buff, 0.0f) == buff.end());
+
+    try {
+        cb::simd::min(buff);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+}
@@ -0,0 +1,146 @@
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t small_allocations = 0;
+
+template<typename T>
+class SmallCountingAllocator : public std::allocator<T> {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = SmallCountingAllocator<U>;
+    };
+public:
+    SmallCountingAllocator() = default;
+
+    template<typename U>
+    SmallCountingAllocator(const SmallCountingAllocator<U>&) noexcept
+    {}
+public:
+    T* allocate(std::size_t n) {
+        ++small_allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+template<typename T, std::size_t N>
+using CountedStatic = CircularBuffer<T, SmallCountingAllocator<T>, ModuloIndexing, NoStats, FixedStorage<N>>;
+
+template<typename T, std::size_t N>
+using CountedSmall = SmallCircularBuffer<T, N, SmallCountingAllocator<T>>;
+
+} // namespace
+
+static_assert(sizeof(CircularBuffer<int>) == sizeof(CircularBuffer<int, std::allocator<int>, ModuloIndexing, NoStats, HeapStorage>));
+static_assert(sizeof(StaticCircularBuffer<int, 16>) >= 17 * sizeof(int));
+
+TEST(SmallBufferTestSuite, StaticNoAllocationTest) {
+    small_allocations = 0;
+
+    CountedStatic<std::string, 4> a;
+
+    ASSERT_TRUE(a.capacity() == 4 && a.empty());
+
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(std::to_string(i));
+    }
+
+    ASSERT_TRUE(a == std::vector<std::string>({"6", "7", "8", "9"}));
+
+    CountedStatic<std::string, 4> b(a);
+    CountedStatic<std::string, 4> c(std::move(b));
+
+    ASSERT_TRUE(b.empty() && b.capacity() == 4);
+    ASSERT_TRUE(c == a);
+
+    b.push_front("x");
+    b = c;
+    c = {"p", "q"};
+    swap(b, c);
+
+    ASSERT_TRUE(b == std::vector<std::string>({"p", "q"}) && c == a);
+    ASSERT_TRUE(small_allocations == 0);
+}
+
+TEST(SmallBufferTestSuite, StaticCapacityTest) {
+    StaticCircularBuffer<int, 8> a(3, 1);
+
+    ASSERT_TRUE(a.capacity() == 3);
+
+    a.push_back(2);
+
+    ASSERT_TRUE(a == std::vector<int>({1, 1, 2}));
+
+    a.reserve(8);
+    a.push_back(3);
+
+    ASSERT_TRUE(a.capacity() == 8 && a == std::vector<int>({1, 1, 2, 3}));
+    ASSERT_THROW(a.reserve(9), std::invalid_argument);
+    ASSERT_THROW((StaticCircularBuffer<int, 8>(9)), std::invalid_argument);
+
+    StaticCircularBuffer<int, 5, PowerOfTwoIndexing> b;
+
+    ASSERT_TRUE(b.capacity() == 8);
+}
+
+TEST(SmallBufferTestSuite, SpillTest) {
+    small_allocations = 0;
+
+    CountedSmall<std::string, 4> a;
+
+    for (int i = 0; i < 4; ++i) {
+        a.push_back(std::to_string(i));
+    }
+
+    ASSERT_TRUE(a.capacity() == 4 && small_allocations == 0);
+
+    a.push_front("-1");
+
+    ASSERT_TRUE(small_allocations == 1 && a.capacity() > 4);
+    ASSERT_TRUE(a == std::vector<std::string>({"-1", "0", "1", "2", "3"}));
+
+    a.pop_back();
+    a.pop_back();
+    a.shrink_to_fit();
+
+    ASSERT_TRUE(a.capacity() == 4 && a == std::vector<std::string>({"-1", "0", "1"}));
+
+    a.push_back("2");
+
+    ASSERT_TRUE(small_allocations == 1);
+}
+
+TEST(SmallBufferTestSuite, MoveAndSwapTest) {
+    CountedSmall<std::string, 2> inline_buffer({"a", "b"});
+    CountedSmall<std::string, 2> heap_buffer({"c", "d", "e"});
+
+    small_allocations = 0;
+
+    CountedSmall<std::string, 2> moved_inline(std::move(inline_buffer));
+    CountedSmall<std::string, 2> moved_heap(std::move(heap_buffer));
+
+    ASSERT_TRUE(moved_inline == std::vector<std::string>({"a", "b"}));
+    ASSERT_TRUE(moved_heap == std::vector<std::string>({"c", "d", "e"}));
+    ASSERT_TRUE(inline_buffer.empty() && heap_buffer.empty());
+    ASSERT_TRUE(small_allocations == 0);
+
+    swap(moved_inline, moved_heap);
+
+    ASSERT_TRUE(moved_inline == std::vector<std::string>({"c", "d", "e"}));
+    ASSERT_TRUE(moved_heap == std::vector<std::string>({"a", "b"}));
+
+    moved_heap = std::move(moved_inline);
+    inline_buffer.push_back("z");
+
+    ASSERT_TRUE(moved_heap == std::vector<std::string>({"c", "d", "e"}));
+    ASSERT_TRUE(inline_buffer == std::vector<std::string>({"z"}));
+    ASSERT_TRUE(small_allocations == 0);
+}
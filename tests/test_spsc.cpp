@@ -0,0 +1,230 @@
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+template<typename Buffer, typename Iterator>
+concept CanPushBulk = requires(Buffer buffer, Iterator it) { buffer.try_push_bulk(it, it); };
+
+} // namespace
+
+// A single-pass range would lose the elements that did not fit.
+static_assert(CanPushBulk<SpscCircularBuffer<int>, std::list<int>::iterator>);
+static_assert(!CanPushBulk<SpscCircularBuffer<int>, std::istream_iterator<int>>);
+
+TEST(SpscBufferTestSuite, CapacityTest) {
+    SpscCircularBuffer<int> buff1(5);
+    SpscCircularBuffer<int> buff2(16);
+
+    ASSERT_TRUE(buff1.capacity() == 8);
+    ASSERT_TRUE(buff2.capacity() == 16);
+    ASSERT_TRUE(buff1.empty());
+}
+
+TEST(SpscBufferTestSuite, PushPopTest) {
+    SpscCircularBuffer<std::string> buff(4);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(buff.try_push(std::to_string(i)));
+    }
+
+    ASSERT_FALSE(buff.try_push("overflow"));
+    ASSERT_TRUE(buff.size() == 4);
+
+    std::string value;
+
+    ASSERT_TRUE(buff.try_pop(value));
+    ASSERT_TRUE(value == "0");
+    ASSERT_TRUE(buff.try_emplace(3, 'x'));
+
+    for (std::string expected : {"1", "2", "3", "xxx"}) {
+        ASSERT_TRUE(buff.try_pop(value));
+        ASSERT_TRUE(value == expected);
+    }
+
+    ASSERT_FALSE(buff.try_pop(value));
+    ASSERT_TRUE(buff.empty());
+}
+
+TEST(SpscBufferTestSuite, BulkTest) {
+    SpscCircularBuffer<int> buff(8);
+    std::vector<int> input = {1, 2, 3, 4, 5, 6};
+
+    ASSERT_TRUE(buff.try_push_bulk(input.begin(), input.end()) == 6);
+    ASSERT_TRUE(buff.try_push_bulk(input.begin(), input.end()) == 2);
+
+    std::vector<int> output(10);
+
+    ASSERT_TRUE(buff.try_pop_bulk(output.begin(), 3) == 3);
+    ASSERT_TRUE(buff.try_pop_bulk(output.begin() + 3, 10) == 5);
+    ASSERT_TRUE(std::vector<int>(output.begin(), output.begin() + 8) == std::vector<int>({1, 2, 3, 4, 5, 6, 1, 2}));
+    ASSERT_TRUE(buff.try_pop_bulk(output.begin(), 10) == 0);
+}
+
+TEST(SpscBufferTestSuite, StressTest) {
+    constexpr int kCount = 200000;
+
+    SpscCircularBuffer<std::string> buff(64);
+
+    std::thread producer([&buff]() {
+        for (int i = 0; i < kCount; ++i) {
+            std::string value = std::to_string(i);
+
+            while (!buff.try_push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ordered = true;
+    int received = 0;
+    std::string value;
+
+    while (received < kCount) {
+        if (!buff.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ordered = ordered && value == std::to_string(received);
+        ++received;
+    }
+
+    producer.join();
+
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(buff.empty());
+}
+
+TEST(SpscBufferTestSuite, BulkStressTest) {
+    constexpr int kCount = 200000;
+
+    SpscCircularBuffer<int> buff(128);
+
+    std::thread producer([&buff]() {
+        std::vector<int> batch(16);
+        int next = 0;
+
+        while (next < kCount) {
+            int batch_size = std::min<int>(batch.size(), kCount - next);
+
+            for (int i = 0; i < batch_size; ++i) {
+                batch[i] = next + i;
+            }
+
+            size_t pushed = buff.try_push_bulk(batch.begin(), batch.begin() + batch_size);
+            next += pushed;
+
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ordered = true;
+    int received = 0;
+    std::vector<int> batch(32);
+
+    while (received < kCount) {
+        size_t popped = buff.try_pop_bulk(batch.begin(), batch.size());
+
+        for (size_t i = 0; i < popped; ++i) {
+            ordered = ordered && batch[i] == received;
+            ++received;
+        }
+
+        if (popped == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+
+    ASSERT_TRUE(ordered);
+}
+
+TEST(SpscBufferTestSuite, PrepareCommitTest) {
+    SpscCircularBuffer<int> buff(8);
+
+    auto slots = buff.prepare(6);
+
+    ASSERT_TRUE(slots.size() == 6 && slots.second.empty());
+
+    std::iota(slots.first.begin(), slots.first.end(), 0);
+    buff.commit(6);
+
+    auto view = buff.peek(4);
+
+    ASSERT_TRUE(view.size() == 4 && view.first[3] == 3);
+
+    buff.consume(4);
+    slots = buff.prepare(100);
+
+    ASSERT_TRUE(slots.first.size() == 2 && slots.second.size() == 4);
+
+    std::iota(slots.first.begin(), slots.first.end(), 6);
+    std::iota(slots.second.begin(), slots.second.end(), 8);
+    buff.commit(6);
+
+    view = buff.peek(100);
+
+    ASSERT_TRUE(view.size() == 8 && view.first.size() == 4 && view.second.size() == 4);
+    ASSERT_TRUE(view.first[0] == 4 && view.second[3] == 11);
+}
+
+TEST(SpscBufferTestSuite, PrepareCommitStressTest) {
+    constexpr int kCount = 200000;
+
+    SpscCircularBuffer<int> buff(128);
+
+    std::thread producer([&buff]() {
+        int next = 0;
+
+        while (next < kCount) {
+            auto slots = buff.prepare(std::min(kCount - next, 24));
+
+            if (slots.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::iota(slots.first.begin(), slots.first.end(), next);
+            std::iota(slots.second.begin(), slots.second.end(), next + static_cast<int>(slots.first.size()));
+            buff.commit(slots.size());
+            next += slots.size();
+        }
+    });
+
+    bool ordered = true;
+    int received = 0;
+
+    while (received < kCount) {
+        auto view = buff.peek(32);
+
+        if (view.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (std::span<int> run : {view.first, view.second}) {
+            for (int value : run) {
+                ordered = ordered && value == received++;
+            }
+        }
+
+        buff.consume(view.size());
+    }
+
+    producer.join();
+
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(buff.empty());
+}
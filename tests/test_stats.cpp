@@ -0,0 +1,120 @@
+#include "../include/circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(CircularBuffer<int>) == sizeof(CircularBuffer<int, std::allocator<int>, ModuloIndexing, NoStats>));
+static_assert(sizeof(CircularBufferExt<int>) == sizeof(CircularBufferExt<int, std::allocator<int>, NoStats>));
+
+TEST(StatsTestSuite, CountersTest) {
+    CircularBuffer<int, std::allocator<int>, ModuloIndexing, CountingStats<int>> buffer;
+    buffer.reserve(3);
+
+    for (int i = 0; i < 5; ++i) {
+        buffer.push_back(i);
+    }
+
+    buffer.pop_front();
+    buffer.pop_back();
+
+    const BufferStats& stats = buffer.stats().snapshot();
+
+    ASSERT_TRUE(stats.pushes == 5);
+    ASSERT_TRUE(stats.pops == 2);
+    ASSERT_TRUE(stats.overwrites == 2);
+    ASSERT_TRUE(stats.peak_size == 3);
+    ASSERT_TRUE(stats.reallocations == 0);
+}
+
+TEST(StatsTestSuite, OverwriteCallbackTest) {
+    CircularBuffer<std::string, std::allocator<std::string>, PowerOfTwoIndexing, CountingStats<std::string>> buffer;
+    buffer.reserve(2);
+    std::vector<std::string> lost;
+
+    buffer.stats().set_overwrite_callback([&lost](const std::string& element) { lost.push_back(element); });
+
+    buffer.push_back("a");
+    buffer.push_back("b");
+    buffer.push_back("c");
+    buffer.push_front("z");
+
+    std::string items[] = {"d", "e", "f"};
+    buffer.push_back_n(items, 3);
+
+    ASSERT_TRUE((lost == std::vector<std::string>{"a", "c", "z", "b", "d"}));
+    ASSERT_TRUE(buffer.stats().snapshot().overwrites == 5);
+    ASSERT_TRUE(buffer.stats().snapshot().pushes == 7);
+}
+
+TEST(StatsTestSuite, InsertIntoFullTest) {
+    CircularBuffer<int, std::allocator<int>, ModuloIndexing, CountingStats<int>> buffer({1, 2, 3, 4});
+    std::vector<int> lost;
+
+    buffer.stats().set_overwrite_callback([&lost](int element) { lost.push_back(element); });
+    buffer.insert(buffer.begin() + 1, 2, 0);
+
+    ASSERT_TRUE((std::vector<int>(buffer.begin(), buffer.end()) == std::vector<int>{1, 0, 0, 2}));
+    ASSERT_TRUE((lost == std::vector<int>{3, 4}));
+    ASSERT_TRUE(buffer.stats().snapshot().pushes == 2);
+}
+
+TEST(StatsTestSuite, ExtReallocationTest) {
+    CircularBufferExt<int, std::allocator<int>, CountingStats<int>> buffer;
+
+    for (int i = 0; i < 100; ++i) {
+        buffer.push_back(i);
+    }
+
+    const BufferStats& stats = buffer.stats().snapshot();
+
+    ASSERT_TRUE(stats.pushes == 100);
+    ASSERT_TRUE(stats.overwrites == 0);
+    ASSERT_TRUE(stats.peak_size == 100);
+    ASSERT_TRUE(stats.reallocations > 1);
+    ASSERT_TRUE(stats.bytes_moved > 0 && stats.bytes_moved < 100 * stats.reallocations * sizeof(int));
+
+    buffer.stats().reset();
+    ASSERT_TRUE(buffer.stats().snapshot().pushes == 0);
+}
+
+TEST(StatsTestSuite, PropagationTest) {
+    CircularBuffer<int, std::allocator<int>, ModuloIndexing, CountingStats<int>> buffer;
+    buffer.reserve(4);
+    buffer.push_back(1);
+
+    auto copy = buffer;
+    ASSERT_TRUE(copy.stats().snapshot().pushes == 1);
+
+    decltype(buffer) other;
+    other.reserve(4);
+    swap(buffer, other);
+    ASSERT_TRUE(buffer.stats().snapshot().pushes == 0 && other.stats().snapshot().pushes == 1);
+}
+
+TEST(StatsTestSuite, PrometheusTest) {
+    BufferStats stats;
+    stats.pushes = 7;
+    stats.overwrites = 2;
+    stats.peak_size = 4;
+
+    cb::StatsSample samples[] = {{"buffer=\"orders\"", stats}, {"buffer=\"trades\"", BufferStats()}};
+    std::ostringstream out;
+
+    cb::write_prometheus(out, "cbuffer", samples);
+
+    std::string text = out.str();
+
+    ASSERT_TRUE(text.find("# TYPE cbuffer_pushes_total counter\n") != std::string::npos);
+    ASSERT_TRUE(text.find("cbuffer_pushes_total{buffer=\"orders\"} 7\n") != std::string::npos);
+    ASSERT_TRUE(text.find("cbuffer_pushes_total{buffer=\"trades\"} 0\n") != std::string::npos);
+    ASSERT_TRUE(text.find("cbuffer_overwrites_total{buffer=\"orders\"} 2\n") != std::string::npos);
+    ASSERT_TRUE(text.find("# TYPE cbuffer_peak_size gauge\n") != std::string::npos);
+
+    std::ostringstream single;
+    cb::write_prometheus(single, "cbuffer", stats);
+
+    ASSERT_TRUE(single.str().find("\ncbuffer_peak_size 4\n") != std::string::npos);
+}
@@ -0,0 +1,171 @@
+#include "../include/windowed_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Counts values above zero, to check that user aggregators plug in.
+template<typename T>
+class PositiveCount {
+public:
+    void Reserve(std::size_t) {}
+
+    void Push(const T& value) {
+        count_ += value > 0;
+    }
+
+    void Evict(const T& value) {
+        count_ -= value > 0;
+    }
+
+    void Clear() {
+        count_ = 0;
+    }
+
+    std::size_t Value() const {
+        return count_;
+    }
+private:
+    std::size_t count_ = 0;
+};
+
+} // namespace
+
+TEST(WindowedBufferTestSuite, MatchesRecomputationTest) {
+    MovingStatistics<int> window(16);
+    std::deque<int> reference;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<int> dist(-20, 20);
+
+    for (int i = 0; i < 1000; ++i) {
+        int value = dist(gen);
+
+        window.push_back(value);
+        reference.push_back(value);
+
+        if (reference.size() > 16) {
+            reference.pop_front();
+        }
+
+        if (i % 7 == 0) {
+            window.pop_front();
+            reference.pop_front();
+        }
+
+        if (reference.empty()) {
+            ASSERT_TRUE(window.empty());
+            continue;
+        }
+
+        double n = reference.size();
+        double mean = std::accumulate(reference.begin(), reference.end(), 0.0) / n;
+        double squares = std::inner_product(reference.begin(), reference.end(), reference.begin(), 0.0);
+
+        ASSERT_TRUE(window.count() == reference.size());
+        ASSERT_TRUE(window.sum() == std::accumulate(reference.begin(), reference.end(), 0));
+        ASSERT_TRUE(window.mean() == mean);
+        ASSERT_TRUE(std::abs(window.variance() - (squares / n - mean * mean)) < 1e-9);
+        ASSERT_TRUE(window.min() == *std::min_element(reference.begin(), reference.end()));
+        ASSERT_TRUE(window.max() == *std::max_element(reference.begin(), reference.end()));
+        ASSERT_TRUE(std::equal(window.begin(), window.end(), reference.begin()));
+    }
+}
+
+TEST(WindowedBufferTestSuite, DuplicateExtremaTest) {
+    MovingStatistics<int> window(3);
+
+    for (int value : {5, 1, 1, 1, 7}) {
+        window.push_back(value);
+    }
+
+    ASSERT_TRUE(window.min() == 1 && window.max() == 7);
+
+    window.push_back(7);
+    window.push_back(7);
+
+    ASSERT_TRUE(window.min() == 7 && window.max() == 7);
+    ASSERT_TRUE(window.variance() == 0.0);
+}
+
+TEST(WindowedBufferTestSuite, FloatingDriftTest) {
+    WindowedCircularBuffer<double, WindowSum> window(4);
+
+    window.push_back(1e16);
+
+    for (int i = 0; i < 1000; ++i) {
+        window.push_back(1.0);
+    }
+
+    ASSERT_TRUE(window.sum() == 4.0);
+}
+
+TEST(WindowedBufferTestSuite, LargeOffsetVarianceTest) {
+    MovingStatistics<double> window(4);
+
+    for (int i = 0; i < 1000; ++i) {
+        window.push_back(1e9 + i % 7);
+    }
+
+    window.clear();
+
+    for (double value : {1e9 + 1, 1e9 + 2, 1e9 + 3, 1e9 + 4}) {
+        window.push_back(value);
+    }
+
+    ASSERT_TRUE(std::abs(window.variance() - 1.25) < 1e-6);
+
+    // Still exact after the window has slid a long way at this offset.
+    for (int i = 5; i < 100000; ++i) {
+        window.push_back(1e9 + i);
+    }
+
+    ASSERT_TRUE(std::abs(window.variance() - 1.25) < 1e-6);
+    ASSERT_TRUE(std::abs(window.mean() - (1e9 + 99997.5)) < 1e-6);
+}
+
+TEST(WindowedBufferTestSuite, CustomAggregatorTest) {
+    WindowedCircularBuffer<int, PositiveCount, WindowMax> window(3);
+
+    window.push_back(1);
+    window.push_back(-1);
+    window.push_back(2);
+
+    ASSERT_TRUE(window.aggregator<PositiveCount>().Value() == 2);
+
+    window.push_back(-3);
+
+    ASSERT_TRUE(window.aggregator<PositiveCount>().Value() == 1);
+    ASSERT_TRUE(window.max() == 2);
+
+    window.clear();
+
+    ASSERT_TRUE(window.empty());
+    ASSERT_TRUE(window.aggregator<PositiveCount>().Value() == 0);
+
+    bool thrown = false;
+
+    try {
+        window.max();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    ASSERT_TRUE(thrown);
+}
+
+TEST(WindowedBufferTestSuite, SelfReferencePushTest) {
+    MovingStatistics<int> window(2);
+
+    window.push_back(1);
+    window.push_back(2);
+    window.push_back(window.front());
+
+    ASSERT_TRUE(window.front() == 2 && window.back() == 1);
+    ASSERT_TRUE(window.sum() == 3 && window.min() == 1);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+
+// Element type that counts the copies and moves made of it, shared by the
+// CircularBuffer and CircularBufferExt tests.
+struct Tracked {
+    static inline std::size_t copies = 0;
+    static inline std::size_t moves = 0;
+
+    int value = 0;
+
+    Tracked() = default;
+
+    Tracked(int v)
+        : value(v)
+    {}
+
+    Tracked(const Tracked& other)
+        : value(other.value)
+    {
+        ++copies;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        ++moves;
+    }
+
+    Tracked& operator=(const Tracked& other) {
+        value = other.value;
+        ++copies;
+
+        return *this;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept {
+        value = other.value;
+        ++moves;
+
+        return *this;
+    }
+
+    bool operator==(const Tracked& other) const {
+        return value == other.value;
+    }
+
+    static void Reset() {
+        copies = 0;
+        moves = 0;
+    }
+};